@@ -0,0 +1,87 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+/*  Measures the cost per sample of the oscillators in DSPTools.
+
+    Build from this directory with an optimising compiler, for example:
+        g++ -std=c++17 -O2 -I../../include OscillatorBenchmark.cpp -o OscillatorBenchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "DSPTools.h"
+
+namespace {
+
+const double sampleRate = 48000.0;
+const float frequency = 440.0f;
+const int blockSize = 512, numBlocks = 20000;
+
+/** Render numBlocks blocks from an oscillator that has been set up and return the time per sample.
+*/
+template <typename Oscillator>
+double measureNanosecondsPerSample(Oscillator& oscillator, float& checksum)
+{
+    std::vector<float> block(blockSize);
+    auto start = std::chrono::steady_clock::now();
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+        oscillator.processBlock(block.data(), blockSize);
+        checksum += block[blockIndex % blockSize];
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano> (end - start).count() / (double (numBlocks) * blockSize);
+}
+
+} // namespace
+
+int main()
+{
+    using namespace DSPTools;
+    const char* names[] = { "Sine", "Triangle", "Square", "Saw" };
+    
+    // The checksum is printed so that the compiler cannot remove the rendering.
+    float checksum = 0.0f;
+    std::printf("Nanoseconds per sample at %.0f Hz in %d sample blocks\n", frequency, blockSize);
+    for (int shape = 0; shape < 4; ++shape) {
+        BasicOscillator<float> basic;
+        basic.setup(sampleRate);
+        basic.setWaveshape(static_cast<BasicOscillator<float>::Waveshape> (shape));
+        basic.setFrequency(frequency);
+        auto basicTime = measureNanosecondsPerSample(basic, checksum);
+        
+        BandLimitedOscillator<float> bandLimited;
+        bandLimited.setup(sampleRate);
+        bandLimited.setWaveshape(static_cast<BandLimitedOscillator<float>::Waveshape> (shape));
+        bandLimited.setFrequency(frequency);
+        bandLimited.setMode(BandLimitedOscillator<float>::polyBlep);
+        auto polyBlepTime = measureNanosecondsPerSample(bandLimited, checksum);
+        bandLimited.setMode(BandLimitedOscillator<float>::minBlep);
+        auto minBlepTime = measureNanosecondsPerSample(bandLimited, checksum);
+        
+        std::printf("%-8s  BasicOscillator %6.2f  polyBLEP %6.2f  minBLEP %6.2f\n", names[shape], basicTime, polyBlepTime, minBlepTime);
+    }
+    std::printf("Checksum %f\n", checksum);
+    return 0;
+}
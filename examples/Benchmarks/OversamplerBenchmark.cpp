@@ -0,0 +1,88 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+/*  Measures the cost of the Oversampler in DSPTools, per sample at the oversampled rate.
+    Build from this directory with an optimising compiler, for example:
+        g++ -std=c++17 -O2 -I../../include OversamplerBenchmark.cpp -o OversamplerBenchmark
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "DSPTools.h"
+
+namespace {
+
+const int blockSize = 512, numChannels = 2, numBlocks = 5000;
+
+/** Upsample and downsample numBlocks blocks, optionally saturating the oversampled audio with
+    the tanh estimate, and return the time per oversampled sample of one channel.
+*/
+double measureNanosecondsPerSample(DSPTools::Oversampler<float>& oversampler, bool saturate, float& checksum)
+{
+    std::vector<std::vector<float>> channels(numChannels, std::vector<float>(blockSize));
+    float* channelPointers[numChannels];
+    for (int channel = 0; channel < numChannels; ++channel) {
+        for (int sample = 0; sample < blockSize; ++sample) {
+            channels[channel][sample] = (sample % 64) / 32.0f - 1.0f;
+        }
+        channelPointers[channel] = channels[channel].data();
+    }
+    DSPTools::AudioBufferInfo<float> block(channelPointers, numChannels, blockSize);
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+        auto oversampledBlock = oversampler.upsample(block);
+        if (saturate) {
+            for (int channel = 0; channel < numChannels; ++channel) {
+                DSPTools::Waveshapers<float>::tanHEstimate(oversampledBlock.getChannelData(channel), oversampledBlock.getNumSamples());
+            }
+        }
+        oversampler.downsample(block);
+        checksum += channels[0][blockIndex % blockSize];
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto numSamples = double (numBlocks) * blockSize * numChannels * oversampler.getOversamplingFactor();
+    return std::chrono::duration<double, std::nano> (end - start).count() / numSamples;
+}
+
+} // namespace
+
+int main()
+{
+    using namespace DSPTools;
+    
+    // The checksum is printed so that the compiler cannot remove the processing.
+    float checksum = 0.0f;
+    std::printf("Nanoseconds per oversampled sample per channel in %d sample blocks\n", blockSize);
+    for (int numStages = 1; numStages <= Oversampler<float>::maxStages; ++numStages) {
+        Oversampler<float> oversampler;
+        oversampler.setup(numStages, blockSize, numChannels);
+        auto roundTripTime = measureNanosecondsPerSample(oversampler, false, checksum);
+        auto saturatedTime = measureNanosecondsPerSample(oversampler, true, checksum);
+        std::printf("%2dx  latency %2d  round trip %5.2f  with tanh %5.2f\n", oversampler.getOversamplingFactor(), oversampler.getLatencyInSamples(), roundTripTime, saturatedTime);
+    }
+    std::printf("Checksum %f\n", checksum);
+    return 0;
+}
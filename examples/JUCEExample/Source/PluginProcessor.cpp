@@ -56,6 +56,15 @@ DSPToolsAudioProcessor::DSPToolsAudioProcessor()
     
     panParameter = parameters.getRawParameterValue("pan");
     panModulationParameter = parameters.getRawParameterValue("panM");
+    
+    gainIndex = parameterRegistry.addParameter(*gainParameter, [this] (float) { updateGain(); });
+    gainModulationIndex = parameterRegistry.addParameter(*gainModulationParameter, [this] (float) { updateGain(); });
+    panIndex = parameterRegistry.addParameter(*panParameter, [this] (float) { updatePanning(); });
+    panModulationIndex = parameterRegistry.addParameter(*panModulationParameter, [this] (float) { updatePanning(); });
+    parameterRegistry.addParameter(*modulationFrequencyParameter, [this] (float frequency) { waveModulator->setFrequency(frequency); });
+    parameterRegistry.addParameter(*modulationShapeParameter, [this] (float shape) { waveModulator->setModulationShape(DSPTools::BasicOscillator<float>::Waveshape (shape)); });
+    registeredParameters = { gainParameter, gainModulationParameter, panParameter, panModulationParameter, modulationFrequencyParameter, modulationShapeParameter };
+    parameterRegistry.setup();
 }
 
 DSPToolsAudioProcessor::~DSPToolsAudioProcessor()
@@ -129,13 +138,39 @@ void DSPToolsAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 {
     waveModulator = std::make_unique<DSPTools::WaveModulator<float>>();
     waveModulator->setup(samplesPerBlock, sampleRate);
+    waveModulator->setControlInterval(32);
+    
+    chain.setup(sampleRate, samplesPerBlock, getMainBusNumOutputChannels());
     
-    gain.setup(sampleRate, samplesPerBlock, getMainBusNumOutputChannels());
+    auto& gain = chain.getEffect<0>();
     gain.setDecibelRange(-60.0, 6.0);
     gain.setGainModulationSource(waveModulator);
     
-    pan.setup(sampleRate, samplesPerBlock, getMainBusNumOutputChannels());
+    auto& pan = chain.getEffect<1>();
     pan.setPannerModulationSource(waveModulator);
+    
+    parameterRegistry.applyAllValues();
+}
+
+void DSPToolsAudioProcessor::pollParameters()
+{
+    // The audio thread is the single producer of parameter changes, so automation arrives every
+    // block, even in offline renders. Unchanged values are skipped by the registry, so this
+    // only queues real changes.
+    for (int index = 0; index < (int) registeredParameters.size(); ++index)
+    {
+        parameterRegistry.setValue(index, registeredParameters[index]->load());
+    }
+}
+
+void DSPToolsAudioProcessor::updateGain()
+{
+    chain.getEffect<0>().setDecibels(parameterRegistry.getValue(gainIndex), parameterRegistry.getValue(gainModulationIndex) / 100.0);
+}
+
+void DSPToolsAudioProcessor::updatePanning()
+{
+    chain.getEffect<1>().setPanning(parameterRegistry.getValue(panIndex) / 100.0, parameterRegistry.getValue(panModulationIndex) / 100.0);
 }
 
 void DSPToolsAudioProcessor::releaseResources()
@@ -163,21 +198,16 @@ void DSPToolsAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
 
-    DSPTools::AudioBufferInfo<float> bufferInfo;
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {
-        bufferInfo.appendChannel(buffer.getNumSamples(), buffer.getWritePointer(channel), channel);
-    }
+    // The buffer info only views the host buffer, so building it never allocates.
+    DSPTools::AudioBufferInfo<float> bufferInfo (buffer.getArrayOfWritePointers(), totalNumInputChannels, buffer.getNumSamples());
     
+    // Only the parameters that changed since the last block are applied.
+    pollParameters();
+    parameterRegistry.processChanges();
     waveModulator->prepareModulationBuffer(buffer.getNumSamples());
-    waveModulator->setModulationShape(DSPTools::BasicOscillator<float>::Waveshape (modulationShapeParameter->load()));
-    waveModulator->setFrequency(modulationFrequencyParameter->load());
-    
-    gain.setDecibels(gainParameter->load(), gainModulationParameter->load() / 100.0);
-    gain.processAudio(bufferInfo);
     
-    pan.setPanning(panParameter->load() / 100.0, panModulationParameter->load() / 100.0);
-    pan.processAudio(bufferInfo);
+    // The gain and panner are fused into a single pass over the buffer.
+    chain.processAudio(bufferInfo);
 }
 
 //==============================================================================
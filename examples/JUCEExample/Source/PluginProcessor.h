@@ -58,6 +58,10 @@ public:
     void setStateInformation (const void* data, int sizeInBytes) override;
 
 private:
+    void pollParameters();
+    void updateGain();
+    void updatePanning();
+    
     juce::AudioProcessorValueTreeState parameters;
     std::atomic<float>* gainParameter = nullptr;
     std::atomic<float>* gainModulationParameter = nullptr;
@@ -66,9 +70,13 @@ private:
     std::atomic<float>* panParameter = nullptr;
     std::atomic<float>* panModulationParameter = nullptr;
     
-    DSPTools::Gain<float> gain;
+    // The host parameters in the order they were added to the registry.
+    std::vector<std::atomic<float>*> registeredParameters;
+    DSPTools::ParameterRegistry<float> parameterRegistry;
+    int gainIndex = 0, gainModulationIndex = 0, panIndex = 0, panModulationIndex = 0;
+    
     std::shared_ptr<DSPTools::WaveModulator<float>> waveModulator;
-    DSPTools::Panner<float> pan;
+    DSPTools::ProcessorChain<float, DSPTools::Gain<float>, DSPTools::Panner<float>> chain;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DSPToolsAudioProcessor)
 };
@@ -0,0 +1,95 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+/*  Measures how far a WaveModulator running at control rate, calculated every 32 samples and
+    interpolated in between, strays from the same modulator calculated every sample.
+
+    For a sine, linear interpolation between points T seconds apart is out by at most
+    A * (2 pi f T)^2 / 8, where A is the amplitude of the curve (0.5, as the modulator runs
+    from 0 to 1). The program returns 1 if the measured error in double precision goes over that
+    bound. The float error is shown as well; at low frequencies it is mostly the rounding of the
+    oscillator phases, which drift apart slowly as they step by different amounts.
+
+    Build from this directory and run, for example:
+        g++ -std=c++17 -O2 -I../../include ControlRateModulationTest.cpp -o ControlRateModulationTest
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "DSPTools.h"
+
+namespace {
+
+const double sampleRate = 48000.0;
+const int maxBlockSize = 512, numBlocks = 400, controlInterval = 32;
+
+/** Render both modulators in blocks of varying size and return the largest difference.
+*/
+template <typename type>
+double measureError(type frequency)
+{
+    using namespace DSPTools;
+    WaveModulator<type> fullRate, controlRate;
+    for (auto* modulator : { &fullRate, &controlRate }) {
+        modulator->setup(maxBlockSize, sampleRate);
+        modulator->setModulationShape(BasicOscillator<type>::Sine);
+        modulator->setFrequency(frequency);
+    }
+    controlRate.setControlInterval(controlInterval);
+    
+    const int blockSizes[] = { 512, 100, 7, 256, 33 };
+    double maxError = 0.0;
+    for (int block = 0; block < numBlocks; ++block) {
+        int blockSize = blockSizes[block % 5];
+        fullRate.prepareModulationBuffer(blockSize);
+        controlRate.prepareModulationBuffer(blockSize);
+        auto expected = fullRate.getModulationBuffer();
+        auto interpolated = controlRate.getModulationBuffer();
+        for (int sample = 0; sample < blockSize; ++sample) {
+            maxError = std::max(maxError, static_cast<double> (std::abs(interpolated[sample] - expected[sample])));
+        }
+    }
+    return maxError;
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = true;
+    std::printf("Sine WaveModulator at a control interval of %d samples against every sample\n", controlInterval);
+    for (double frequency : { 1.0, 5.0, 20.0, 50.0 }) {
+        auto step = 2.0 * DSPTools::Maths<double>::pi * frequency * controlInterval / sampleRate;
+        // The error reaches the bound at the peaks, so allow a little for rounding.
+        auto bound = 1.01 * 0.5 * step * step / 8.0 + 1e-9;
+        auto error = measureError<double>(frequency);
+        auto floatError = measureError<float>(static_cast<float> (frequency));
+        passed &= (error <= bound);
+        std::printf("%5.1f Hz: largest error %.2e (%.1f dB), bound %.2e, in float %.2e\n", frequency, error, 20.0 * std::log10(error), bound, floatError);
+    }
+    std::printf(passed ? "Passed\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+/*  Checks the fast maths approximations against the standard library, and fails if any error
+    is larger than the maximum documented in FastMathsPolicies.h. The scalar functions and the
+    buffer functions, which run on the widest instruction set of the CPU, are both checked.
+
+    Build from this directory and run, for example:
+        g++ -std=c++17 -O2 -I../../include FastMathsAccuracyTest.cpp -o FastMathsAccuracyTest
+    The program returns 1 if any error is over its bound.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "DSPTools.h"
+
+namespace {
+
+const int numPoints = 2000000;
+
+/** Relative and absolute error measures.
+*/
+double relativeError(double approximate, double exact)
+{
+    return std::abs(approximate - exact) / std::abs(exact);
+}
+
+double absoluteError(double approximate, double exact)
+{
+    return std::abs(approximate - exact);
+}
+
+/** Sweep a function from start to end, logarithmically if isLogarithmic, through both the
+    scalar and the buffer version, and return the largest error against the exact function.
+*/
+template <typename type>
+double measureError(std::function<type (type)> scalar, std::function<void (type*, int)> buffer, std::function<double (double)> exact,
+                    std::function<double (double, double)> error, double start, double end, bool isLogarithmic)
+{
+    std::vector<type> inputs(numPoints), outputs(numPoints);
+    for (int point = 0; point < numPoints; ++point) {
+        auto position = point / (numPoints - 1.0);
+        inputs[point] = static_cast<type> (isLogarithmic ? start * std::pow(end / start, position) : start + (end - start) * position);
+    }
+    outputs = inputs;
+    buffer(outputs.data(), numPoints);
+    double maxError = 0.0;
+    for (int point = 0; point < numPoints; ++point) {
+        auto expected = exact(inputs[point]);
+        maxError = std::max(maxError, error(scalar(inputs[point]), expected));
+        maxError = std::max(maxError, error(outputs[point], expected));
+    }
+    return maxError;
+}
+
+/** Check every function of one accuracy policy in one precision against its bound.
+*/
+template <typename type, typename Accuracy>
+bool checkAccuracy(const char* name, const double (&bounds)[5])
+{
+    using Maths = DSPTools::FastMaths<type, Accuracy>;
+    bool isFloat = sizeof (type) == sizeof (float);
+    const char* functionNames[] = { "exp2", "log2", "sine", "decibelsToAmplitude", "amplitudeToDecibels" };
+    double errors[5] = {
+        measureError<type>([] (type x) { return Maths::exp2(x); }, [] (type* data, int size) { Maths::exp2(data, size); },
+                           [] (double x) { return std::exp2(x); }, relativeError, -60.0, 60.0, false),
+        measureError<type>([] (type x) { return Maths::log2(x); }, [] (type* data, int size) { Maths::log2(data, size); },
+                           [] (double x) { return std::log2(x); }, absoluteError, 1e-30, 1e4, true),
+        measureError<type>([] (type x) { return Maths::sine(x); }, [] (type* data, int size) { Maths::sine(data, size); },
+                           [] (double x) { return std::sin(2.0 * DSPTools::Maths<double>::pi * x); }, absoluteError, 0.0, 1.0, false),
+        measureError<type>([] (type x) { return Maths::decibelsToAmplitude(x); }, [] (type* data, int size) { Maths::decibelsToAmplitude(data, size); },
+                           [] (double x) { return std::pow(10.0, x / 20.0); }, relativeError, -200.0, 40.0, false),
+        measureError<type>([] (type x) { return Maths::amplitudeToDecibels(x); }, [] (type* data, int size) { Maths::amplitudeToDecibels(data, size); },
+                           [] (double x) { return 20.0 * std::log10(x); }, absoluteError, 1e-30, 1e4, true)
+    };
+    bool passed = true;
+    for (int function = 0; function < 5; ++function) {
+        bool isWithinBound = errors[function] <= bounds[function];
+        passed &= isWithinBound;
+        std::printf("%-6s %-14s %-20s error %.2e  bound %.2e  %s\n", isFloat ? "float" : "double", name, functionNames[function], errors[function], bounds[function], isWithinBound ? "ok" : "FAILED");
+    }
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    using namespace DSPTools;
+    // The documented maximum errors, in the order exp2, log2, sine, decibelsToAmplitude and amplitudeToDecibels.
+    const double highBounds[5] = { 8.3e-8, 2.1e-6, 6.0e-7, 8.3e-8, 1.3e-5 };
+    const double highFloatBounds[5] = { 2.0e-7, 6.5e-6, 7.5e-7, 1.6e-6, 7.5e-5 };
+    const double lowBounds[5] = { 8.6e-5, 7.8e-4, 6.8e-5, 8.6e-5, 4.7e-3 };
+    const double lowFloatBounds[5] = { 8.7e-5, 7.8e-4, 6.9e-5, 8.8e-5, 4.8e-3 };
+    
+    bool passed = true;
+    passed &= checkAccuracy<double, HighAccuracy>("HighAccuracy", highBounds);
+    passed &= checkAccuracy<float, HighAccuracy>("HighAccuracy", highFloatBounds);
+    passed &= checkAccuracy<double, LowAccuracy>("LowAccuracy", lowBounds);
+    passed &= checkAccuracy<float, LowAccuracy>("LowAccuracy", lowFloatBounds);
+    std::printf(passed ? "Passed\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
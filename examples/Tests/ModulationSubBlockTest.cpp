@@ -0,0 +1,106 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+/*  Checks that a modulated parameter gives the same values whether a block is filled whole or
+    as a series of sub-blocks, with and without automation events.
+
+    Build from this directory and run, for example:
+        g++ -std=c++17 -O2 -I../../include ModulationSubBlockTest.cpp -o ModulationSubBlockTest
+    The program returns 1 if the values differ.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "DSPTools.h"
+
+namespace {
+
+const double sampleRate = 48000.0;
+const int blockSize = 512, numBlocks = 50;
+
+/** Set up a parameter with a cutoff-like range, fed by a source at full modulation depth.
+*/
+void setupParameter(DSPTools::ModulationParameter<float>& parameter, std::shared_ptr<DSPTools::ModulationSource<float>> source)
+{
+    parameter.setup(sampleRate, 1, 1000.0f, 0.05f);
+    parameter.setParameterRange(20.0f, 20000.0f);
+    parameter.setParameterValue(1000.0f, 0.5f);
+    parameter.setModulationSource(source);
+}
+
+/** Render every block once whole and once in sub-blocks of the given sizes, and return the
+    largest difference between the two.
+*/
+float compareSubBlocks(const std::vector<int>& subBlockSizes, bool withEvents)
+{
+    using namespace DSPTools;
+    auto source = std::make_shared<WaveModulator<float>>();
+    source->setup(blockSize, sampleRate);
+    source->setModulationShape(BasicOscillator<float>::Sine);
+    source->setFrequency(30.0f);
+    
+    ModulationParameter<float> whole, split;
+    setupParameter(whole, source);
+    setupParameter(split, source);
+    std::vector<float> wholeBlock(blockSize), splitBlock(blockSize);
+    float maxDifference = 0.0f;
+    for (int block = 0; block < numBlocks; ++block) {
+        source->prepareModulationBuffer(blockSize);
+        if (withEvents) {
+            for (auto* parameter : { &whole, &split }) {
+                parameter->addEvent(100, 4000.0f, 0.5f);
+                parameter->addEvent(300, 500.0f, 0.25f);
+            }
+        }
+        whole.fillBlock(0, wholeBlock.data(), blockSize);
+        int start = 0;
+        for (int index = 0; start < blockSize; ++index) {
+            int length = std::min(subBlockSizes[index % subBlockSizes.size()], blockSize - start);
+            split.fillBlock(0, splitBlock.data() + start, length);
+            start += length;
+        }
+        for (int sample = 0; sample < blockSize; ++sample) {
+            maxDifference = std::max(maxDifference, std::abs(wholeBlock[sample] - splitBlock[sample]));
+        }
+    }
+    return maxDifference;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<std::vector<int>> patterns = { { 32 }, { 1, 7, 64, 100 }, { 256 } };
+    bool passed = true;
+    for (int withEvents = 0; withEvents < 2; ++withEvents) {
+        for (auto& pattern : patterns) {
+            auto difference = compareSubBlocks(pattern, withEvents == 1);
+            passed &= (difference == 0.0f);
+            std::printf("Sub-blocks starting at %d samples%s: largest difference %g\n", pattern[0], withEvents ? ", with events" : "", difference);
+        }
+    }
+    std::printf(passed ? "Passed\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
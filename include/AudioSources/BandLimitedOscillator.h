@@ -0,0 +1,372 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_BAND_LIMITED_OSCILLATOR_HEADER_INCLUDED
+#define DSPTOOLS_BAND_LIMITED_OSCILLATOR_HEADER_INCLUDED
+
+#include <complex>
+#include <vector>
+#include "Oscillator.h"
+#include "../Utilities/Maths.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** An oscillator that removes the aliasing of the naive waveshapes in Maths by correcting
+    the samples around each discontinuity.
+    The polyBlep mode adds a two sample polynomial correction, which is cheap and removes
+    most of the audible aliasing. The minBlep mode adds a 32 sample residual read from a
+    shared minimum phase table, which suppresses aliasing much further. The triangle has no
+    steps, only corners, and uses polynomial corrections to its corners in both modes.
+    In the minBlep mode the output is delayed by the group delay of the table, about 3 samples.
+*/
+template <typename type>
+class BandLimitedOscillator : Oscillator<type>
+{
+public:
+    enum Waveshape {
+        Sine = 0,
+        Triangle = 1,
+        Square = 2,
+        Saw = 3
+    };
+    
+    enum Mode {
+        polyBlep = 0,
+        minBlep = 1
+    };
+    
+    BandLimitedOscillator() {}
+    ~BandLimitedOscillator() {}
+    
+    /** Setup the oscillator. The shared minBLEP table is built by the first call.
+    */
+    void setup(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        phase = 0.0;
+        increment = 0.1;
+        kernels = &VectorOperations<type>::getBest();
+        getStepDelay();
+        residuals.resize(residualLength);
+        reset();
+    }
+    
+    /** Set the oscillator frequency. This must be below a quarter of the sample rate.
+    */
+    void setFrequency(type frequency)
+    {
+        increment = frequency / sampleRate;
+        assert(increment >= 0.0 && increment < 0.25);
+    }
+    
+    /** Set the waveshape for the oscillator.
+    */
+    void setWaveshape(Waveshape waveshape)
+    {
+        currentWaveshape = waveshape;
+        reset();
+    }
+    
+    /** Set how the discontinuities are corrected.
+    */
+    void setMode(Mode newMode)
+    {
+        mode = newMode;
+        reset();
+    }
+    
+    /** Get the next sample value from the oscillator.
+    */
+    type getNextSample()
+    {
+        type value;
+        processBlock(&value, 1);
+        return value;
+    }
+    
+    /** Fill a buffer with the next samples from the oscillator.
+    */
+    void processBlock(type* dest, int numSamples)
+    {
+        if (numSamples <= 0) {
+            return;
+        }
+        phase = kernels->generatePhases(dest, numSamples, phase, increment);
+        switch (currentWaveshape) {
+            case Sine:
+                FastMaths<type>::sine(dest, numSamples);
+                break;
+            case Triangle:
+                processTriangle(dest, numSamples);
+                break;
+            case Square:
+            case Saw:
+                if (mode == polyBlep) {
+                    processPolyBlep(dest, numSamples);
+                } else {
+                    processMinBlep(dest, numSamples);
+                }
+                break;
+            default:
+                std::fill(dest, dest + numSamples, type(0.0));
+                break;
+        }
+    }
+    
+private:
+    static constexpr int zeroCrossings = 16, oversampling = 64, residualLength = 2 * zeroCrossings;
+    
+    /** Clear the minBLEP corrections that have not been output yet.
+    */
+    void reset()
+    {
+        std::fill(residuals.begin(), residuals.end(), type (0.0));
+        residualPosition = 0;
+    }
+    
+    /** The correction for a step of 2 that happened phase0to1 ago, or is 1 - phase0to1 ahead.
+    */
+    type getPolyBlep(type phase0to1)
+    {
+        if (phase0to1 < increment) {
+            auto t = phase0to1 / increment;
+            return t + t - t * t - type (1.0);
+        } else if (phase0to1 > type (1.0) - increment) {
+            auto t = (phase0to1 - type (1.0)) / increment;
+            return t * t + t + t + type (1.0);
+        }
+        return 0.0;
+    }
+    
+    /** The correction for a corner whose slope increases by 1 per sample.
+    */
+    type getPolyBlamp(type phase0to1)
+    {
+        type t = 0.0;
+        if (phase0to1 < increment) {
+            t = type (1.0) - phase0to1 / increment;
+        } else if (phase0to1 > type (1.0) - increment) {
+            t = type (1.0) + (phase0to1 - type (1.0)) / increment;
+        }
+        return t * t * t / type (6.0);
+    }
+    
+    void processTriangle(type* data, int numSamples)
+    {
+        // The slope changes by -8 per cycle at a phase of 0.25 and by 8 at 0.75.
+        auto cornerScale = type (8.0) * increment;
+        for (int sample = 0; sample < numSamples; ++sample) {
+            auto phase0to1 = data[sample];
+            auto risingCorner = phase0to1 + type (0.25);
+            auto fallingCorner = phase0to1 + type (0.75);
+            risingCorner -= (risingCorner >= 1.0) ? type (1.0) : type (0.0);
+            fallingCorner -= (fallingCorner >= 1.0) ? type (1.0) : type (0.0);
+            data[sample] = Maths<type>::generateTriangle(phase0to1) + cornerScale * (getPolyBlamp(risingCorner) - getPolyBlamp(fallingCorner));
+        }
+    }
+    
+    void processPolyBlep(type* data, int numSamples)
+    {
+        if (currentWaveshape == Saw) {
+            for (int sample = 0; sample < numSamples; ++sample) {
+                data[sample] = Maths<type>::generateSaw(data[sample]) + getPolyBlep(data[sample]);
+            }
+            return;
+        }
+        for (int sample = 0; sample < numSamples; ++sample) {
+            auto phase0to1 = data[sample];
+            auto fallingEdge = phase0to1 + type (0.5);
+            fallingEdge -= (fallingEdge >= 1.0) ? type (1.0) : type (0.0);
+            data[sample] = ((phase0to1 < 0.5) ? type (1.0) : type (-1.0)) + getPolyBlep(phase0to1) - getPolyBlep(fallingEdge);
+        }
+    }
+    
+    void processMinBlep(type* data, int numSamples)
+    {
+        // The minimum phase steps lag the naive steps by the group delay of the table. The naive
+        // waveform is delayed by the same amount so that the ramps stay in line with the steps
+        // and the saw has no DC offset.
+        auto delay = getStepDelay() * increment;
+        auto last = data[0] - increment;
+        last += (last < 0.0) ? type (1.0) : type (0.0);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            auto phase0to1 = data[sample];
+            auto delayedPhase = phase0to1 - delay;
+            delayedPhase += (delayedPhase < 0.0) ? type (1.0) : type (0.0);
+            type value;
+            if (currentWaveshape == Saw) {
+                value = Maths<type>::generateSaw(delayedPhase);
+                if (phase0to1 < last) {
+                    addResidual(phase0to1 / increment, 2.0);
+                }
+            } else {
+                value = (delayedPhase < 0.5) ? type (1.0) : type (-1.0);
+                if (phase0to1 < last) {
+                    addResidual(phase0to1 / increment, 2.0);
+                } else if (last < 0.5 && phase0to1 >= 0.5) {
+                    addResidual((phase0to1 - type (0.5)) / increment, -2.0);
+                }
+            }
+            last = phase0to1;
+            data[sample] = value + residuals[residualPosition];
+            residuals[residualPosition] = 0.0;
+            residualPosition = (residualPosition + 1) & (residualLength - 1);
+        }
+    }
+    
+    /** Add the difference between a minimum phase step of the given height that started
+        samplesAgo samples before the current sample and the delayed naive step.
+    */
+    void addResidual(type samplesAgo, type height)
+    {
+        const auto& table = getStepTable();
+        auto delay = getStepDelay();
+        for (int sample = 0; sample < residualLength; ++sample) {
+            auto time = samplesAgo + sample;
+            type position = time * oversampling;
+            auto index = static_cast<int> (position);
+            auto fraction = position - index;
+            auto step = table[index] + fraction * (table[index + 1] - table[index]);
+            residuals[(residualPosition + sample) & (residualLength - 1)] += height * (step - ((time >= delay) ? type (1.0) : type (0.0)));
+        }
+    }
+    
+    /** The group delay of the minimum phase step in samples, which is the area between it and
+        a unit step.
+    */
+    static type getStepDelay()
+    {
+        static const type delay = calculateStepDelay();
+        return delay;
+    }
+    
+    static type calculateStepDelay()
+    {
+        double area = 0.0;
+        for (auto step : getStepTable()) {
+            area += 1.0 - step;
+        }
+        return static_cast<type> (area / oversampling);
+    }
+    
+    /** A minimum phase band-limited unit step, sampled at oversampling points per sample.
+    */
+    static const std::vector<type>& getStepTable()
+    {
+        static const std::vector<type> table = createStepTable();
+        return table;
+    }
+    
+    static std::vector<type> createStepTable()
+    {
+        // A Blackman windowed sinc is made minimum phase through its real cepstrum and then
+        // integrated into a step.
+        const int impulseLength = residualLength * oversampling + 1, size = 8192;
+        std::vector<std::complex<double>> spectrum(size);
+        for (int point = 0; point < impulseLength; ++point) {
+            auto time = (point - zeroCrossings * oversampling) / static_cast<double> (oversampling);
+            auto sinc = (time == 0.0) ? 1.0 : std::sin(Maths<double>::pi * time) / (Maths<double>::pi * time);
+            auto window = 0.42 - 0.5 * std::cos(2.0 * Maths<double>::pi * point / (impulseLength - 1))
+                               + 0.08 * std::cos(4.0 * Maths<double>::pi * point / (impulseLength - 1));
+            spectrum[point] = sinc * window;
+        }
+        transform(spectrum, false);
+        for (auto& bin : spectrum) {
+            bin = std::log(std::max(std::abs(bin), 1e-10));
+        }
+        transform(spectrum, true);
+        for (int point = 1; point < size / 2; ++point) {
+            spectrum[point] = 2.0 * spectrum[point].real();
+        }
+        for (int point = size / 2 + 1; point < size; ++point) {
+            spectrum[point] = 0.0;
+        }
+        spectrum[0] = spectrum[0].real();
+        spectrum[size / 2] = spectrum[size / 2].real();
+        transform(spectrum, false);
+        for (auto& bin : spectrum) {
+            bin = std::exp(bin);
+        }
+        transform(spectrum, true);
+        
+        std::vector<double> step(impulseLength);
+        double sum = 0.0;
+        for (int point = 0; point < impulseLength; ++point) {
+            sum += spectrum[point].real();
+            step[point] = sum;
+        }
+        std::vector<type> table(impulseLength + 1, type (1.0));
+        for (int point = 0; point < impulseLength; ++point) {
+            table[point] = static_cast<type> (step[point] / sum);
+        }
+        return table;
+    }
+    
+    /** An in-place radix 2 FFT. The inverse transform is scaled by 1 / size.
+    */
+    static void transform(std::vector<std::complex<double>>& data, bool inverse)
+    {
+        const int size = static_cast<int> (data.size());
+        for (int i = 1, j = 0; i < size; ++i) {
+            int bit = size >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+            if (i < j) {
+                std::swap(data[i], data[j]);
+            }
+        }
+        for (int length = 2; length <= size; length <<= 1) {
+            auto angle = 2.0 * Maths<double>::pi / length * (inverse ? 1.0 : -1.0);
+            std::complex<double> rotation(std::cos(angle), std::sin(angle));
+            for (int start = 0; start < size; start += length) {
+                std::complex<double> twiddle(1.0);
+                for (int k = 0; k < length / 2; ++k) {
+                    auto even = data[start + k];
+                    auto odd = data[start + k + length / 2] * twiddle;
+                    data[start + k] = even + odd;
+                    data[start + k + length / 2] = even - odd;
+                    twiddle *= rotation;
+                }
+            }
+        }
+        if (inverse) {
+            for (auto& value : data) {
+                value /= static_cast<double> (size);
+            }
+        }
+    }
+    
+    Waveshape currentWaveshape = Sine;
+    Mode mode = polyBlep;
+    std::vector<type> residuals;
+    int residualPosition = 0;
+    type phase = 0.0, increment = 0.0;
+    double sampleRate = 1.0;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_BAND_LIMITED_OSCILLATOR_HEADER_INCLUDED
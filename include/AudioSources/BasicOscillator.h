@@ -24,6 +24,8 @@ SOFTWARE.*/
 #define DSPTOOLS_BASIC_OSCILLATOR_HEADER_INCLUDED
 
 #include "Oscillator.h"
+#include "../Utilities/Maths.h"
+#include "../Utilities/VectorOperations.h"
 
 namespace DSPTools {
 
@@ -48,6 +50,7 @@ public:
         this->sampleRate = sampleRate;
         phase = 0.0;
         increment = 0.1;
+        kernels = &VectorOperations<type>::getBest();
     }
     
     /** Set the oscillator frequency.
@@ -94,10 +97,51 @@ public:
         return value;
     }
     
+    /** Fill a buffer with the next samples from the oscillator.
+    */
+    void processBlock(type* dest, int numSamples)
+    {
+        phase = kernels->generatePhases(dest, numSamples, phase, increment);
+        switch (currentWaveshape) {
+            case Sine:
+                applyWaveshape<Maths<type>::generateSine>(dest, numSamples);
+                break;
+            case Triangle:
+                applyWaveshape<Maths<type>::generateTriangle>(dest, numSamples);
+                break;
+            case Square:
+                applyWaveshape<Maths<type>::generateSquare>(dest, numSamples);
+                break;
+            case Saw:
+                applyWaveshape<Maths<type>::generateSaw>(dest, numSamples);
+                break;
+            default:
+                std::fill(dest, dest + numSamples, type(0.0));
+                break;
+        }
+    }
+    
+    /** Advance the oscillator by a number of samples without calculating them.
+    */
+    void skip(int numSamples)
+    {
+        phase += increment * numSamples;
+        phase -= std::floor(phase);
+    }
+    
 private:
+    template <type (*generate)(type)>
+    static void applyWaveshape(type* data, int numSamples)
+    {
+        for (int sample = 0; sample < numSamples; ++sample) {
+            data[sample] = generate(data[sample]);
+        }
+    }
+    
     Waveshape currentWaveshape;
     type phase, increment;
     double sampleRate;
+    const VectorOperations<type>* kernels = nullptr;
 };
 
 } // namespace DSPTools
@@ -0,0 +1,126 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_OSCILLATOR_BANK_HEADER_INCLUDED
+#define DSPTOOLS_OSCILLATOR_BANK_HEADER_INCLUDED
+
+#include <array>
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** A fixed number of oscillators that are rendered together, for additive and unison sounds.
+    The phases, increments, waveshapes and gains of the voices are stored as separate arrays,
+    so the kernels advance one voice per register lane: 8 or 16 voices per instruction with
+    AVX2 or AVX-512. The sine is the fast approximation from FastMaths and the other
+    waveshapes are the naive ones from Maths, so they will alias.
+*/
+template <typename type, int numVoices>
+class OscillatorBank
+{
+public:
+    enum Waveshape {
+        Sine = 0,
+        Triangle = 1,
+        Square = 2,
+        Saw = 3
+    };
+    
+    OscillatorBank() {}
+    ~OscillatorBank() {}
+    
+    /** Setup the oscillator bank. Every voice starts as a silent sine with a gain of 1.
+    */
+    void setup(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        phases.fill(0.0);
+        increments.fill(0.0);
+        waveshapes.fill(static_cast<type> (Sine));
+        gains.fill(1.0);
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Set the frequency of a voice.
+    */
+    void setFrequency(int voice, type frequency)
+    {
+        assert(voice >= 0 && voice < numVoices);
+        increments[voice] = frequency / sampleRate;
+    }
+    
+    /** Set the waveshape of a voice.
+    */
+    void setWaveshape(int voice, Waveshape waveshape)
+    {
+        assert(voice >= 0 && voice < numVoices);
+        waveshapes[voice] = static_cast<type> (waveshape);
+    }
+    
+    /** Set the gain that the output of a voice is multiplied by.
+    */
+    void setGain(int voice, type gain)
+    {
+        assert(voice >= 0 && voice < numVoices);
+        gains[voice] = gain;
+    }
+    
+    /** Set the phase of a voice from 0 to 1.
+    */
+    void setPhase(int voice, type phase0to1)
+    {
+        assert(voice >= 0 && voice < numVoices);
+        phases[voice] = phase0to1 - std::floor(phase0to1);
+    }
+    
+    /** Fill one buffer per voice with the next samples of that voice, multiplied by its gain.
+    */
+    void processBlock(type* const* voiceOutputs, int numSamples)
+    {
+        kernels->renderOscillators(phases.data(), increments.data(), waveshapes.data(), gains.data(), voiceOutputs, numVoices, numSamples);
+    }
+    
+    /** Fill a buffer with the sum of the next samples of every voice, multiplied by their gains.
+    */
+    void processSummedBlock(type* dest, int numSamples)
+    {
+        kernels->sumOscillators(phases.data(), increments.data(), waveshapes.data(), gains.data(), dest, numVoices, numSamples);
+    }
+    
+    /** Get the number of voices in the bank.
+    */
+    static constexpr int getNumVoices()
+    {
+        return numVoices;
+    }
+    
+private:
+    static_assert(numVoices > 0, "An OscillatorBank needs at least one voice");
+    
+    std::array<type, numVoices> phases, increments, waveshapes, gains;
+    double sampleRate = 1.0;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_OSCILLATOR_BANK_HEADER_INCLUDED
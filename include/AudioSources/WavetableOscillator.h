@@ -0,0 +1,263 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_WAVETABLE_OSCILLATOR_HEADER_INCLUDED
+#define DSPTOOLS_WAVETABLE_OSCILLATOR_HEADER_INCLUDED
+
+#include <limits>
+#include <vector>
+#include "Oscillator.h"
+#include "../Utilities/Maths.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** An oscillator that reads band-limited waveforms from precomputed tables.
+    Each waveshape has one table per octave, built by adding harmonics up to the limit of
+    that octave. The table for the current frequency is chosen when the frequency is set, so
+    the output does not alias. The tables are built once and shared by every oscillator.
+*/
+template <typename type>
+class WavetableOscillator : Oscillator<type>
+{
+public:
+    enum Waveshape {
+        Sine = 0,
+        Triangle = 1,
+        Square = 2,
+        Saw = 3
+    };
+    
+    enum Interpolation {
+        linear = 0,
+        cubic = 1
+    };
+    
+    WavetableOscillator() {}
+    ~WavetableOscillator() {}
+    
+    /** Setup the oscillator. The shared tables are built by the first call.
+    */
+    void setup(double sampleRate)
+    {
+        this->sampleRate = sampleRate;
+        phase = 0.0;
+        increment = 0.1;
+        kernels = &VectorOperations<type>::getBest();
+        getTables();
+        selectTable();
+    }
+    
+    /** Set the oscillator frequency. A negative frequency plays the waveform backwards.
+    */
+    void setFrequency(type frequency)
+    {
+        increment = frequency / sampleRate;
+        selectTable();
+    }
+    
+    /** Set the waveshape for the oscillator.
+    */
+    void setWaveshape(Waveshape waveshape)
+    {
+        currentWaveshape = waveshape;
+        selectTable();
+    }
+    
+    /** Set how the oscillator interpolates between table points.
+    */
+    void setInterpolation(Interpolation newInterpolation)
+    {
+        interpolation = newInterpolation;
+    }
+    
+    /** Get the next sample value from the oscillator.
+    */
+    type getNextSample()
+    {
+        type value = (interpolation == cubic) ? readCubic(phase) : readLinear(phase);
+        phase += increment;
+        if (phase >= 1.0 || phase < 0.0) {
+            phase = wrapPhase(phase);
+        }
+        return value;
+    }
+    
+    /** Fill a buffer with the next samples from the oscillator.
+    */
+    void processBlock(type* dest, int numSamples)
+    {
+        if (increment >= 0.0) {
+            phase = kernels->generatePhases(dest, numSamples, phase, increment);
+        } else {
+            // The phase kernel only counts upwards, so run the mirror image of the phase forwards
+            // and reflect each phase back.
+            auto mirroredPhase = kernels->generatePhases(dest, numSamples, mirrorPhase(phase), -increment);
+            for (int sample = 0; sample < numSamples; ++sample) {
+                dest[sample] = mirrorPhase(dest[sample]);
+            }
+            phase = mirrorPhase(mirroredPhase);
+        }
+        if (interpolation == cubic) {
+            for (int sample = 0; sample < numSamples; ++sample) {
+                dest[sample] = readCubic(dest[sample]);
+            }
+        } else {
+            for (int sample = 0; sample < numSamples; ++sample) {
+                dest[sample] = readLinear(dest[sample]);
+            }
+        }
+    }
+    
+    /** Advance the oscillator by a number of samples without calculating them.
+    */
+    void skip(int numSamples)
+    {
+        phase = wrapPhase(phase + increment * numSamples);
+    }
+    
+private:
+    static constexpr int tableSize = 2048, numLevels = 11;
+    
+    // Each table holds one guard point before the waveform and two after it, so the cubic
+    // interpolation can read four neighbouring points without wrapping.
+    using Tables = std::vector<std::vector<type>>;
+    
+    /** Wrap a phase into [0, 1). Just below a whole number, the subtraction can round up to 1,
+        which would read past the end of the table, so that is taken as 0.
+    */
+    static type wrapPhase(type phase)
+    {
+        phase -= std::floor(phase);
+        return (phase < 1.0) ? phase : type (0.0);
+    }
+    
+    /** Get the phase that is as far below a whole cycle as the given phase is above it.
+    */
+    static type mirrorPhase(type phase0to1)
+    {
+        return wrapPhase(type (1.0) - phase0to1);
+    }
+    
+    type readLinear(type phase0to1)
+    {
+        type position = phase0to1 * tableSize;
+        auto index = static_cast<int> (position);
+        auto fraction = position - index;
+        const type* points = table + index + 1;
+        return points[0] + fraction * (points[1] - points[0]);
+    }
+    
+    type readCubic(type phase0to1)
+    {
+        type position = phase0to1 * tableSize;
+        auto index = static_cast<int> (position);
+        auto fraction = position - index;
+        const type* points = table + index;
+        auto c1 = type (0.5) * (points[2] - points[0]);
+        auto c2 = points[0] - type (2.5) * points[1] + type (2.0) * points[2] - type (0.5) * points[3];
+        auto c3 = type (0.5) * (points[3] - points[0]) + type (1.5) * (points[1] - points[2]);
+        return ((c3 * fraction + c2) * fraction + c1) * fraction + points[1];
+    }
+    
+    /** Choose the table with the most harmonics that all stay below Nyquist.
+    */
+    void selectTable()
+    {
+        auto maxHarmonic = type (0.5) / std::max(std::abs(increment), std::numeric_limits<type>::min());
+        int level = 0;
+        while (level < numLevels - 1 && ((tableSize / 2) >> level) > maxHarmonic) {
+            ++level;
+        }
+        table = getTables()[currentWaveshape * numLevels + level].data();
+    }
+    
+    static const Tables& getTables()
+    {
+        static const Tables tables = createTables();
+        return tables;
+    }
+    
+    static Tables createTables()
+    {
+        std::vector<double> sine(tableSize);
+        for (int point = 0; point < tableSize; ++point) {
+            sine[point] = std::sin(2.0 * Maths<double>::pi * point / tableSize);
+        }
+        
+        Tables tables;
+        for (int shape = Sine; shape <= Saw; ++shape) {
+            for (int level = 0; level < numLevels; ++level) {
+                std::vector<double> wave(tableSize, 0.0);
+                int numHarmonics = (tableSize / 2) >> level;
+                for (int harmonic = 1; harmonic <= numHarmonics; ++harmonic) {
+                    auto amplitude = getHarmonicAmplitude(static_cast<Waveshape> (shape), harmonic);
+                    if (amplitude == 0.0) {
+                        continue;
+                    }
+                    for (int point = 0; point < tableSize; ++point) {
+                        wave[point] += amplitude * sine[(harmonic * point) & (tableSize - 1)];
+                    }
+                }
+                std::vector<type> table(tableSize + 3);
+                table[0] = static_cast<type> (wave[tableSize - 1]);
+                for (int point = 0; point < tableSize; ++point) {
+                    table[point + 1] = static_cast<type> (wave[point]);
+                }
+                table[tableSize + 1] = table[1];
+                table[tableSize + 2] = table[2];
+                tables.push_back(std::move(table));
+            }
+        }
+        return tables;
+    }
+    
+    /** The Fourier series of the waveshapes in Maths.
+    */
+    static double getHarmonicAmplitude(Waveshape shape, int harmonic)
+    {
+        bool isOdd = (harmonic % 2) == 1;
+        switch (shape) {
+            case Sine:
+                return (harmonic == 1) ? 1.0 : 0.0;
+            case Triangle:
+                return isOdd ? ((harmonic % 4 == 1) ? 8.0 : -8.0) / (Maths<double>::pi * Maths<double>::pi * harmonic * harmonic) : 0.0;
+            case Square:
+                return isOdd ? 4.0 / (Maths<double>::pi * harmonic) : 0.0;
+            case Saw:
+                return 2.0 / (Maths<double>::pi * harmonic);
+            default:
+                return 0.0;
+        }
+    }
+    
+    Waveshape currentWaveshape = Sine;
+    Interpolation interpolation = linear;
+    const type* table = nullptr;
+    type phase = 0.0, increment = 0.0;
+    double sampleRate = 1.0;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_WAVETABLE_OSCILLATOR_HEADER_INCLUDED
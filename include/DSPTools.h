@@ -27,14 +27,36 @@ SOFTWARE.*/
 #include "Utilities/Maths.h"
 #include "Utilities/Waveshapers.h"
 #include "Utilities/AudioBufferInfo.h"
+#include "Utilities/AlignedAudioBuffer.h"
 #include "Utilities/EnvelopeFollower.h"
+#include "Utilities/GainComputer.h"
+#include "Utilities/SlidingWindowMaximum.h"
+#include "Utilities/TruePeakDetector.h"
+#include "Utilities/CPUFeatures.h"
+#include "Utilities/VectorOperations.h"
+#include "Utilities/WorkStealingQueue.h"
+#include "Utilities/ParameterEventQueue.h"
+#include "Utilities/Oversampler.h"
 
 #include "Processors/Gain.h"
 #include "Processors/Compressor.h"
 #include "Processors/Panner.h"
+#include "Processors/Limiter.h"
+#include "Processors/ProcessorChain.h"
+#include "Processors/ProcessingGraph.h"
+#include "Processors/OversampledEffect.h"
+#include "Processors/Waveshaper.h"
+#include "Processors/Biquad.h"
+#include "Processors/FilterCascade.h"
+#include "Processors/MultibandCompressor.h"
 
 #include "Modulation/WaveModulator.h"
+#include "Modulation/ModulationMatrix.h"
+#include "Modulation/ParameterRegistry.h"
 
 #include "AudioSources/BasicOscillator.h"
+#include "AudioSources/WavetableOscillator.h"
+#include "AudioSources/BandLimitedOscillator.h"
+#include "AudioSources/OscillatorBank.h"
 
 #endif // DSPTOOLS_HEADER_INCLUDED
@@ -0,0 +1,183 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_MODULATION_MATRIX_HEADER_INCLUDED
+#define DSPTOOLS_MODULATION_MATRIX_HEADER_INCLUDED
+
+#include <memory>
+#include <vector>
+#include "ModulationSource.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** Routes many modulation sources to many destinations with a depth for each pair.
+    process() renders every source that is routed somewhere once, then builds each destination
+    curve as the depth weighted sum of its sources, skipping the pairs with zero depth, so the
+    block costs one pass per active route. Each destination is itself a ModulationSource whose
+    buffer holds its curve, so it can be given to ModulationParameter::setModulationSource, or
+    read directly with getDestinationBuffer. A parameter fed by the matrix should use a
+    modulation value of 1, as the depth is already applied.
+*/
+template <typename type>
+class ModulationMatrix
+{
+public:
+    ModulationMatrix() {}
+    ~ModulationMatrix() {}
+    
+    /** Add a source to the matrix and return its index. The source must be set up by its owner,
+        and the matrix starts its blocks, so nothing else should call prepareModulationBuffer on it.
+    */
+    int addSource(std::shared_ptr<ModulationSource<type>> source)
+    {
+        sources.push_back(std::move(source));
+        return static_cast<int> (sources.size()) - 1;
+    }
+    
+    /** Add a destination to the matrix and return its index.
+    */
+    int addDestination()
+    {
+        destinations.push_back(std::make_shared<Destination>());
+        return static_cast<int> (destinations.size()) - 1;
+    }
+    
+    /** Setup the destinations and clear every depth. This must be called after adding the
+        sources and destinations, and before calling process.
+    */
+    void setup(int maxBufferSize, double sampleRate)
+    {
+        for (auto& destination : destinations) {
+            destination->setup(maxBufferSize, sampleRate);
+        }
+        depths.assign(sources.size() * destinations.size(), 0.0);
+        routes.resize(destinations.size());
+        for (auto& destinationRoutes : routes) {
+            destinationRoutes.clear();
+            destinationRoutes.reserve(sources.size());
+        }
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Set the depth from a source to a destination. A depth of zero removes the route.
+        This does not allocate, so it can be called from the audio thread between blocks.
+    */
+    void setDepth(int source, int destination, type depth)
+    {
+        assert(source >= 0 && source < static_cast<int> (sources.size()));
+        assert(destination >= 0 && destination < static_cast<int> (destinations.size()));
+        auto& current = depths[destination * sources.size() + source];
+        if (current == depth) {
+            return;
+        }
+        current = depth;
+        auto& destinationRoutes = routes[destination];
+        destinationRoutes.clear();
+        for (int index = 0; index < static_cast<int> (sources.size()); ++index) {
+            auto routeDepth = depths[destination * sources.size() + index];
+            if (routeDepth != 0.0) {
+                destinationRoutes.push_back({index, routeDepth});
+            }
+        }
+    }
+    
+    /** Get the depth from a source to a destination.
+    */
+    type getDepth(int source, int destination) const
+    {
+        return depths[destination * sources.size() + source];
+    }
+    
+    /** Start a block in every source and calculate every destination curve for it. Only the
+        sources that are routed somewhere are read, so only they calculate their samples.
+    */
+    void process(int numSamples)
+    {
+        for (auto& source : sources) {
+            source->prepareModulationBuffer(numSamples);
+        }
+        for (int destination = 0; destination < static_cast<int> (destinations.size()); ++destination) {
+            destinations[destination]->prepareModulationBuffer(numSamples);
+            auto curve = destinations[destination]->getCurve();
+            std::fill(curve, curve + numSamples, type (0.0));
+            for (auto& route : routes[destination]) {
+                kernels->addScaled(curve, sources[route.source]->getModulationBuffer(), route.depth, numSamples);
+            }
+        }
+    }
+    
+    /** Get the curve of a destination for the last processed block.
+    */
+    const type* getDestinationBuffer(int destination) const
+    {
+        return destinations[destination]->getModulationBuffer();
+    }
+    
+    /** Get a destination as a modulation source for a ModulationParameter.
+    */
+    std::shared_ptr<ModulationSource<type>> getDestination(int destination) const
+    {
+        return destinations[destination];
+    }
+    
+    int getNumSources() const
+    {
+        return static_cast<int> (sources.size());
+    }
+    
+    int getNumDestinations() const
+    {
+        return static_cast<int> (destinations.size());
+    }
+    
+private:
+    /** A destination curve, written by the matrix rather than calculated by itself.
+    */
+    class Destination : public ModulationSource<type>
+    {
+    public:
+        void calculateModulationBuffer(type* /*dest*/, int /*numSamples*/) override {}
+        
+        type* getCurve()
+        {
+            return this->getWritableModulationBuffer();
+        }
+    };
+    
+    struct Route
+    {
+        int source;
+        type depth;
+    };
+    
+    std::vector<std::shared_ptr<ModulationSource<type>>> sources;
+    std::vector<std::shared_ptr<Destination>> destinations;
+    std::vector<type> depths;
+    std::vector<std::vector<Route>> routes;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_MODULATION_MATRIX_HEADER_INCLUDED
@@ -23,16 +23,28 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_MODULATION_PARAMETER_HEADER_INCLUDED
 #define DSPTOOLS_MODULATION_PARAMETER_HEADER_INCLUDED
 
+#include <algorithm>
+#include <vector>
 #include "ModulationSource.h"
 #include "../Utilities/Range.h"
 #include "../Utilities/SmoothedValue.h"
 
 namespace DSPTools {
 
+/** A smoothed parameter with an optional modulation source.
+    Besides setParameterValue, which takes effect from the next sample, automation can be
+    given sample accurately with addEvent. Events are timed from the start of the next block
+    the parameter renders, and fillBlock splits the block at each event so that the new target
+    starts moving on exactly that sample.
+*/
 template <typename type>
 class ModulationParameter
 {
 public:
+    /** The number of events one block can hold. Space for them is allocated in setup.
+    */
+    static constexpr int maxEventsPerBlock = 256;
+    
     ModulationParameter () {}
     ~ModulationParameter() {}
     
@@ -43,12 +55,27 @@ public:
         parameterValue.resize(numChannels);
         modulationValue.resize(numChannels);
         currentModulatedParameterValue.resize(numChannels);
+        nextEvents.assign(numChannels, 0);
+        eventTimes.assign(numChannels, 0);
+        modulationPositions.assign(numChannels, 0);
+        modulationVersions.assign(numChannels, 0);
+        events.clear();
+        events.reserve(maxEventsPerBlock);
         for (int channel = 0; channel < numChannels; ++channel) {
             parameterValue[channel].setup(sampleRate, initialValue, smoothingTime);
             modulationValue[channel].setup(sampleRate, 0.0, smoothingTime);
         }
     }
     
+    /** Set whether the parameter value moves to new values in linear or exponential ramps.
+    */
+    void setSmoothingMode(typename SmoothedValue<type>::Mode mode)
+    {
+        for (auto& value : parameterValue) {
+            value.setMode(mode);
+        }
+    }
+    
     /** Set the range for the parameter.
     */
     void setParameterRange(type minValue, type maxValue)
@@ -66,21 +93,80 @@ public:
         }
     }
     
+    /** Set the value for the parameter without changing its modulation value.
+    */
+    void setParameterValue(type parameter)
+    {
+        for (auto& value : parameterValue) {
+            value.setTargetValue(parameter);
+        }
+    }
+    
+    /** Set the value for the parameter and its modulation value, skipping straight to them
+        rather than smoothing.
+    */
+    void setCurrentAndTargetParameterValue(type parameter, type modulation)
+    {
+        for (int channel = 0; channel < static_cast<int> (parameterValue.size()); ++channel) {
+            parameterValue[channel].setCurrentAndTargetValue(parameter);
+            modulationValue[channel].setCurrentAndTargetValue(modulation);
+        }
+    }
+    
+    /** Set the modulation value without changing the value for the parameter.
+    */
+    void setModulationValue(type modulation)
+    {
+        for (auto& value : modulationValue) {
+            value.setTargetValue(modulation);
+        }
+    }
+    
+    /** Set the value for the parameter and its modulation value from a sample offset within the
+        next block. Events may be added in any order, and events at the same offset take effect in
+        the order they were added. The first event added after a block has
+        been rendered replaces the events of that block. Nothing is allocated; returns false,
+        dropping the event, if the block already holds maxEventsPerBlock events.
+    */
+    bool addEvent(int sampleOffset, type parameter, type modulation)
+    {
+        assert(sampleOffset >= 0);
+        if (hasRenderedEvents) {
+            events.clear();
+            std::fill(nextEvents.begin(), nextEvents.end(), 0);
+            std::fill(eventTimes.begin(), eventTimes.end(), 0);
+            hasRenderedEvents = false;
+        }
+        if (events.size() == events.capacity()) {
+            return false;
+        }
+        auto position = std::upper_bound(events.begin(), events.end(), sampleOffset, [] (int offset, const Event& event) { return offset < event.sampleOffset; });
+        events.insert(position, {sampleOffset, parameter, modulation});
+        return true;
+    }
+    
     /** Set the modulation source.
     */
     void setModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
     {
             this->modulationSource = modulationSource;
+            std::fill(modulationPositions.begin(), modulationPositions.end(), 0);
+            std::fill(modulationVersions.begin(), modulationVersions.end(), modulationSource ? modulationSource->getVersion() : 0);
     }
     
     /** Modulate a parameter value.
     */
     type getNextModulatedParameterValue(int channel, int sampleIndex)
     {
+        hasRenderedEvents = true;
+        if (nextEvents[channel] < static_cast<int> (events.size())) {
+            applyEvents(channel, eventTimes[channel]);
+            ++eventTimes[channel];
+        }
         type staticParameterValue = parameterValue[channel].getNextValue();
         type thisModulationValue = modulationValue[channel].getNextValue();
         
-        if (!modulationSource)
+        if (!modulationSource || thisModulationValue == 0.0)
         {
             currentModulatedParameterValue[channel] = staticParameterValue;
             return parameterRange.constrainValueToRange(staticParameterValue);
@@ -97,6 +183,59 @@ public:
         return parameterRange.constrainValueToRange(currentModulatedParameterValue[channel]);
     }
     
+    /** Fill a buffer with the next modulated parameter values for a channel.
+        This gives the same values as calling getNextModulatedParameterValue for sample
+        indexes 0 to numSamples - 1, but does the work in loops over each segment of the buffer
+        between automation events. A block of the modulation source can be filled in several
+        calls, e.g. for the sub-blocks of a buffer, as each call reads on from where the last
+        one stopped until the source starts a new block.
+        Returns true if every value written to the buffer is the same. Callers that only read
+        dest[0] from a constant block can set fillConstantBlock to false to skip writing the rest.
+    */
+    bool fillBlock(int channel, type* dest, int numSamples, bool fillConstantBlock = true)
+    {
+        assert(numSamples > 0);
+        auto& staticParameterValue = parameterValue[channel];
+        auto& thisModulationValue = modulationValue[channel];
+        
+        hasRenderedEvents = true;
+        int numEvents = static_cast<int> (events.size());
+        int blockStart = eventTimes[channel];
+        int modulationStart = advanceModulationPosition(channel, numSamples);
+        bool hasEvents = nextEvents[channel] < numEvents && events[nextEvents[channel]].sampleOffset < blockStart + numSamples;
+        if (nextEvents[channel] < numEvents) {
+            eventTimes[channel] += numSamples;
+        }
+        
+        if (!hasEvents && !isModulationActive(channel) && !staticParameterValue.isSmoothing())
+        {
+            thisModulationValue.skip(numSamples);
+            currentModulatedParameterValue[channel] = staticParameterValue.getCurrentValue();
+            std::fill(dest, dest + (fillConstantBlock ? numSamples : 1), parameterRange.constrainValueToRange(currentModulatedParameterValue[channel]));
+            return true;
+        }
+        
+        int start = 0;
+        while (start < numSamples) {
+            applyEvents(channel, blockStart + start);
+            int end = numSamples;
+            if (nextEvents[channel] < numEvents) {
+                end = std::min(end, events[nextEvents[channel]].sampleOffset - blockStart);
+            }
+            renderSegment(channel, dest, start, end, modulationStart);
+            start = end;
+        }
+        
+        currentModulatedParameterValue[channel] = dest[numSamples - 1];
+        
+        auto minValue = parameterRange.getMinValue();
+        auto maxValue = parameterRange.getMaxValue();
+        for (int sample = 0; sample < numSamples; ++sample) {
+            dest[sample] = Maths<type>::limit(minValue, maxValue, dest[sample]);
+        }
+        return false;
+    }
+    
     /** Get the last output modulated parameter value.
     */
     type getCurrentModulatedParameterValue(int channel)
@@ -105,6 +244,85 @@ public:
     }
     
 private:
+    struct Event
+    {
+        int sampleOffset;
+        type parameter, modulation;
+    };
+    
+    /** Apply every event of a channel that is due at or before a sample of the event block.
+    */
+    void applyEvents(int channel, int time)
+    {
+        auto& next = nextEvents[channel];
+        int numEvents = static_cast<int> (events.size());
+        while (next < numEvents && events[next].sampleOffset <= time) {
+            parameterValue[channel].setTargetValue(events[next].parameter);
+            modulationValue[channel].setTargetValue(events[next].modulation);
+            ++next;
+        }
+    }
+    
+    /** Returns true if the modulation source changes the parameter of a channel. The source is
+        only read, and so only calculated, while this is true.
+    */
+    bool isModulationActive(int channel)
+    {
+        return modulationSource && (modulationValue[channel].isSmoothing() || modulationValue[channel].getCurrentValue() != 0.0);
+    }
+    
+    /** Returns the position in the buffer of the modulation source that the next numSamples
+        samples of a channel start at, and moves the channel past them. The position goes back to
+        the start of the buffer when the source starts a new block.
+    */
+    int advanceModulationPosition(int channel, int numSamples)
+    {
+        if (!modulationSource) {
+            return 0;
+        }
+        // A longer block would read past the end of the source, e.g. a base rate source feeding an OversampledEffect.
+        assert(numSamples <= modulationSource->getMaxBufferSize());
+        auto& position = modulationPositions[channel];
+        auto version = modulationSource->getVersion();
+        if (version != modulationVersions[channel] || position + numSamples > modulationSource->getNumSamples()) {
+            modulationVersions[channel] = version;
+            position = 0;
+        }
+        int start = position;
+        position += numSamples;
+        return start;
+    }
+    
+    /** Write the modulated parameter values from start to end of a block, during which the
+        targets do not change. The modulation samples are read from modulationStart onwards.
+    */
+    void renderSegment(int channel, type* dest, int start, int end, int modulationStart)
+    {
+        auto& staticParameterValue = parameterValue[channel];
+        auto& thisModulationValue = modulationValue[channel];
+        staticParameterValue.fillRamp(dest + start, end - start);
+        
+        if (!isModulationActive(channel)) {
+            thisModulationValue.skip(end - start);
+        } else if (thisModulationValue.isSmoothing()) {
+            auto modulationSamples = modulationSource->getModulationBuffer() + modulationStart;
+            for (int sample = start; sample < end; ++sample) {
+                dest[sample] = applyModulation(dest[sample], modulationSamples[sample] * thisModulationValue.getNextValue());
+            }
+        } else {
+            auto modulationSamples = modulationSource->getModulationBuffer() + modulationStart;
+            auto modulationDepth = thisModulationValue.getCurrentValue();
+            for (int sample = start; sample < end; ++sample) {
+                dest[sample] = applyModulation(dest[sample], modulationSamples[sample] * modulationDepth);
+            }
+        }
+    }
+    
+    type applyModulation(type currentValue, type modAmount)
+    {
+        return calculateModulatedParameter(currentValue, Maths<type>::limit(-1.0, 1.0, modAmount));
+    }
+    
     type calculateModulatedParameter(type currentValue, type modAmount)
     {
         return (modAmount > 0.0) ? currentValue + (parameterRange.getMaxValue() - currentValue) * modAmount : currentValue + (currentValue - parameterRange.getMinValue()) * modAmount;
@@ -114,6 +332,10 @@ private:
     Range<type> parameterRange;
     std::vector<SmoothedValue<type>> parameterValue, modulationValue;
     std::vector<type> currentModulatedParameterValue;
+    std::vector<Event> events;
+    std::vector<int> nextEvents, eventTimes, modulationPositions;
+    std::vector<unsigned long> modulationVersions;
+    bool hasRenderedEvents = false;
 };
 
 } // namespace DSPTools
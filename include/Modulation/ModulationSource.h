@@ -23,8 +23,27 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_MODULATION_SOURCE_HEADER_INCLUDED
 #define DSPTOOLS_MODULATION_SOURCE_HEADER_INCLUDED
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+
 namespace DSPTools {
 
+/** A source of modulation samples for a block of audio.
+    prepareModulationBuffer only starts a new block. The samples are calculated the first
+    time the block is read, at most once per block, so a source that nothing reads, for example
+    because every parameter it feeds has a modulation depth of zero, costs nothing. The samples
+    of blocks that were never read are skipped rather than calculated, so the source stays in
+    time with the audio.
+    The first read of a block claims the calculation, and any other thread that reads the
+    block meanwhile waits until it is ready, so one source can feed nodes of a
+    ProcessingGraph that run in parallel and is still calculated exactly once per block.
+    prepareModulationBuffer and setModulationSample must not run while the block is being read.
+    A source can also run at control rate, where it is calculated once every few samples and
+    the block is filled by linear interpolation between those points.
+*/
 template <typename type>
 class ModulationSource
 {
@@ -33,19 +52,92 @@ public:
     */
     virtual void setup(int maxBufferSize, double sampleRate)
     {
-        samples.resize(maxBufferSize);
+        samples.setup(1, maxBufferSize);
+        controlPoints.assign(maxBufferSize / 2 + 3, type (0.0));
         this->sampleRate = sampleRate;
+        kernels = &VectorOperations<type>::getBest();
+        needsControlPoints = true;
+    }
+    
+    /** Calculate the source once every numSamples samples and fill the blocks by linear
+        interpolation between those points. Slow sources such as LFOs sound the same at an
+        interval of 16 or 32 samples, for a fraction of the cost. An interval of 1, the default,
+        calculates every sample. The interpolation restarts from the current position of the
+        source, so this should be set before processing.
+    */
+    virtual void setControlInterval(int numSamples)
+    {
+        assert(numSamples >= 1);
+        controlInterval = numSamples;
+        needsControlPoints = true;
+    }
+    
+    /** Get the number of samples between calculated points.
+    */
+    int getControlInterval() const
+    {
+        return controlInterval;
     }
     
-    /** Calculate the modulation samples for the length of the buffer.
+    /** Start a new block of modulation samples with the length of the buffer.
     */
-    virtual void prepareModulationBuffer(int numSamples) = 0;
+    void prepareModulationBuffer(int numSamples)
+    {
+        assert(numSamples <= samples.getNumSamples());
+        if (calculationState.load(std::memory_order_acquire) != ready) {
+            if (controlInterval == 1) {
+                skipModulationSamples(blockSize);
+            } else {
+                skipControlPoints(blockSize);
+            }
+        }
+        blockSize = numSamples;
+        ++version;
+        calculationState.store(pending, std::memory_order_release);
+    }
     
     /** Get a modulation sample from the buffer.
     */
     virtual type getModulationSample(int sampleIndex)
     {
-        return samples[sampleIndex];
+        calculateIfNeeded();
+        return samples.getChannelData(0)[sampleIndex];
+    }
+    
+    /** Get a pointer to the start of the modulation sample buffer, which is aligned to 64 bytes.
+    */
+    const type* getModulationBuffer()
+    {
+        calculateIfNeeded();
+        return samples.getChannelData(0);
+    }
+    
+    /** Returns a count that goes up by one with every block.
+    */
+    unsigned long getVersion() const
+    {
+        return version;
+    }
+    
+    /** Get the largest block the source was set up for.
+    */
+    int getMaxBufferSize() const
+    {
+        return samples.getNumSamples();
+    }
+    
+    /** Get the number of samples in the current block.
+    */
+    int getNumSamples() const
+    {
+        return blockSize;
+    }
+    
+    /** Returns true if the current block has been calculated.
+    */
+    bool isBufferCalculated() const
+    {
+        return calculationState.load(std::memory_order_acquire) == ready;
     }
     
     virtual ~ModulationSource() {};
@@ -54,12 +146,122 @@ public:
     */
     void setModulationSample(int sampleIndex, type value)
     {
-        samples[sampleIndex] = value;
+        calculateIfNeeded();
+        samples.getChannelData(0)[sampleIndex] = value;
+    }
+    
+protected:
+    /** Calculate the modulation samples for the current block. At a control interval above 1,
+        this is asked for the control points instead, which are getControlInterval() samples apart.
+    */
+    virtual void calculateModulationBuffer(type* dest, int numSamples) = 0;
+    
+    /** Advance past a block of samples that was never read. Sources with state that moves on
+        over time, such as the phase of an oscillator, should override this. Like
+        calculateModulationBuffer, this counts control points at a control interval above 1.
+    */
+    virtual void skipModulationSamples(int /*numSamples*/) {}
+    
+    /** Get a writable pointer to the start of the modulation sample buffer, for sources that
+        fill the buffer themselves outside calculateModulationBuffer.
+    */
+    type* getWritableModulationBuffer()
+    {
+        return samples.getChannelData(0);
     }
     
 private:
-    std::vector<type> samples;
+    enum CalculationState {pending, calculating, ready};
+    
+    /** Calculate the block if no thread has yet, or wait for the thread that is calculating it.
+    */
+    void calculateIfNeeded()
+    {
+        if (calculationState.load(std::memory_order_acquire) == ready) {
+            return;
+        }
+        int expected = pending;
+        if (!calculationState.compare_exchange_strong(expected, calculating, std::memory_order_acquire)) {
+            while (calculationState.load(std::memory_order_acquire) != ready) {
+                // The calculation of one block is short, so wait for it rather than sleeping.
+            }
+            return;
+        }
+        if (controlInterval == 1) {
+            calculateModulationBuffer(samples.getChannelData(0), blockSize);
+        } else {
+            interpolateControlPoints(samples.getChannelData(0), blockSize);
+        }
+        calculationState.store(ready, std::memory_order_release);
+    }
+    
+    /** Calculate the first two control points, which are kept at the start of controlPoints
+        as the segment the next block starts in.
+    */
+    void startControlPoints()
+    {
+        calculateModulationBuffer(controlPoints.data(), 2);
+        segmentPosition = 0;
+        needsControlPoints = false;
+    }
+    
+    void interpolateControlPoints(type* dest, int numSamples)
+    {
+        if (needsControlPoints) {
+            startControlPoints();
+        }
+        auto points = controlPoints.data();
+        auto numNewPoints = (segmentPosition + numSamples) / controlInterval;
+        assert(numNewPoints + 2 <= static_cast<int> (controlPoints.size()));
+        if (numNewPoints > 0) {
+            calculateModulationBuffer(points + 2, numNewPoints);
+        }
+        int segment = 0;
+        for (int sample = 0; sample < numSamples;) {
+            auto numSegmentSamples = std::min(controlInterval - segmentPosition, numSamples - sample);
+            auto increment = (points[segment + 1] - points[segment]) / controlInterval;
+            kernels->linearRamp(dest + sample, numSegmentSamples, points[segment], increment, segmentPosition);
+            sample += numSegmentSamples;
+            segmentPosition += numSegmentSamples;
+            if (segmentPosition == controlInterval) {
+                segmentPosition = 0;
+                ++segment;
+            }
+        }
+        points[0] = points[segment];
+        points[1] = points[segment + 1];
+    }
+    
+    /** Move the control points on by a block without interpolating, calculating only the two
+        points of the segment the next block starts in.
+    */
+    void skipControlPoints(int numSamples)
+    {
+        if (needsControlPoints) {
+            startControlPoints();
+        }
+        auto points = controlPoints.data();
+        auto numNewPoints = (segmentPosition + numSamples) / controlInterval;
+        segmentPosition = (segmentPosition + numSamples) % controlInterval;
+        if (numNewPoints == 1) {
+            points[0] = points[1];
+            calculateModulationBuffer(points + 1, 1);
+        } else if (numNewPoints > 1) {
+            skipModulationSamples(numNewPoints - 2);
+            calculateModulationBuffer(points, 2);
+        }
+    }
+    
+    AlignedAudioBuffer<type> samples;
+    std::vector<type> controlPoints;
+    const VectorOperations<type>* kernels = nullptr;
     double sampleRate = 1.0;
+    unsigned long version = 0;
+    int blockSize = 0;
+    int controlInterval = 1;
+    int segmentPosition = 0;
+    std::atomic<int> calculationState {ready};
+    bool needsControlPoints = true;
 };
 
 } // namespace DSPTools
@@ -0,0 +1,142 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_PARAMETER_REGISTRY_HEADER_INCLUDED
+#define DSPTOOLS_PARAMETER_REGISTRY_HEADER_INCLUDED
+
+#include <functional>
+#include "ModulationParameter.h"
+#include "../Utilities/ParameterEventQueue.h"
+
+namespace DSPTools {
+
+/** Routes parameter changes from a control thread to their targets on the audio thread.
+    The control thread calls setValue as often as it likes, and the audio thread calls
+    processChanges once per block, which applies each parameter that changed since the last
+    call exactly once, with its latest value. The audio thread does no work for parameters that
+    have not changed. The producer can also be the audio thread itself, polling the host's
+    parameter values at the start of each block, which keeps automation in step with the
+    blocks when the host renders faster than real time.
+ 
+    Parameters are added, and setup called, before either thread starts using the registry.
+    A parameter can target the value or the modulation value of a ModulationParameter, or any
+    function taking the new value.
+*/
+template <typename type>
+class ParameterRegistry
+{
+public:
+    ParameterRegistry() {}
+    ~ParameterRegistry() {}
+    
+    /** Add a parameter that calls a function with its new value, and return its index.
+    */
+    int addParameter(type initialValue, std::function<void(type)> onChange)
+    {
+        initialValues.push_back(initialValue);
+        values.push_back(initialValue);
+        targets.push_back(std::move(onChange));
+        return static_cast<int> (targets.size()) - 1;
+    }
+    
+    /** Add a parameter that sets the value of a ModulationParameter, and return its index.
+    */
+    int addParameter(type initialValue, ModulationParameter<type>& target)
+    {
+        return addParameter(initialValue, [&target] (type value) { target.setParameterValue(value); });
+    }
+    
+    /** Add a parameter that sets the modulation value of a ModulationParameter, and return its index.
+    */
+    int addModulationDepth(type initialValue, ModulationParameter<type>& target)
+    {
+        return addParameter(initialValue, [&target] (type value) { target.setModulationValue(value); });
+    }
+    
+    /** Allocate the change queue. This must be called after adding the parameters.
+    */
+    void setup()
+    {
+        queue.setup(initialValues);
+    }
+    
+    /** Set the value of a parameter. Only one thread, which may be the audio thread, may call this.
+    */
+    void setValue(int parameter, type value)
+    {
+        queue.push(parameter, value);
+    }
+    
+    /** Apply every parameter change since the last call. Only the audio thread may call this.
+        Returns the number of parameters applied.
+    */
+    int processChanges()
+    {
+        int numChanges = 0;
+        int parameter;
+        type value;
+        while (queue.pop(parameter, value)) {
+            values[parameter] = value;
+            targets[parameter](value);
+            ++numChanges;
+        }
+        return numChanges;
+    }
+    
+    /** Apply the latest value of every parameter, whether or not it changed, e.g. after the
+        targets have been set up again. Only the audio thread, or a thread that owns the
+        targets while the audio thread is stopped, may call this.
+    */
+    void applyAllValues()
+    {
+        processChanges();
+        for (int parameter = 0; parameter < getNumParameters(); ++parameter) {
+            values[parameter] = queue.getLatestValue(parameter);
+            targets[parameter](values[parameter]);
+        }
+    }
+    
+    /** Get the last value applied to a parameter, for targets that depend on several parameters.
+        Only the audio thread may call this.
+    */
+    type getValue(int parameter) const
+    {
+        return values[parameter];
+    }
+    
+    /** Get the number of parameters in the registry.
+    */
+    int getNumParameters() const
+    {
+        return static_cast<int> (targets.size());
+    }
+    
+private:
+    std::vector<type> initialValues, values;
+    std::vector<std::function<void(type)>> targets;
+    ParameterEventQueue<type> queue;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_PARAMETER_REGISTRY_HEADER_INCLUDED
@@ -25,10 +25,14 @@ SOFTWARE.*/
 
 #include "ModulationSource.h"
 #include "../AudioSources/BasicOscillator.h"
+#include "../AudioSources/WavetableOscillator.h"
 
 namespace DSPTools {
 
-template <typename type>
+/** A modulation source driven by an oscillator.
+    The oscillator can be a BasicOscillator or a band-limited WavetableOscillator.
+*/
+template <typename type, template <typename> class OscillatorType = BasicOscillator>
 class WaveModulator : public ModulationSource<type>
 {
 public:    
@@ -41,21 +45,15 @@ public:
     {
         ModulationSource<type>::setup(maxBufferSize, sampleRate);
         oscillator.setup(sampleRate);
-    }
-    
-    /** Calculate the modulation samples for the length of the buffer.
-    */
-    void prepareModulationBuffer(int numSamples) override
-    {
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            this->setModulationSample(sample, oscillator.getNextSample() * 0.5 + 0.5);
+        if (frequency != 0.0) {
+            // Keep a frequency set before setup in Hz at the new sample rate.
+            oscillator.setFrequency(frequency * this->getControlInterval());
         }
     }
     
     /** Set the waveshape for the modulating oscillator.
     */
-    void setModulationShape(typename BasicOscillator<type>::Waveshape waveshape)
+    void setModulationShape(typename OscillatorType<type>::Waveshape waveshape)
     {
         oscillator.setWaveshape(waveshape);
     }
@@ -64,11 +62,42 @@ public:
     */
     void setFrequency(type frequency)
     {
-        oscillator.setFrequency(frequency);
+        this->frequency = frequency;
+        oscillator.setFrequency(frequency * this->getControlInterval());
+    }
+    
+    /** Calculate the oscillator once every numSamples samples. The oscillator steps from one
+        control point to the next, so a wavetable oscillator also picks its tables for the
+        lower rate.
+    */
+    void setControlInterval(int numSamples) override
+    {
+        ModulationSource<type>::setControlInterval(numSamples);
+        oscillator.setFrequency(frequency * numSamples);
+    }
+    
+protected:
+    /** Calculate the modulation samples for the block.
+    */
+    void calculateModulationBuffer(type* samples, int numSamples) override
+    {
+        oscillator.processBlock(samples, numSamples);
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            samples[sample] = samples[sample] * 0.5 + 0.5;
+        }
+    }
+    
+    /** Move the oscillator past samples that were never read.
+    */
+    void skipModulationSamples(int numSamples) override
+    {
+        oscillator.skip(numSamples);
     }
     
 private:
-    BasicOscillator<type> oscillator;
+    OscillatorType<type> oscillator;
+    type frequency = 0.0;
 };
 
 } // namespace DSPTools
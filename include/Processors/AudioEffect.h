@@ -40,6 +40,11 @@ public:
     /** Process a buffer of audio with the audio effect.
     */
     virtual void processAudio(AudioBufferInfo<type>& audioBuffer) = 0;
+    
+    /** Get the delay the audio effect adds to the audio in samples.
+    */
+    virtual int getLatencyInSamples() { return 0; }
+    
     virtual ~AudioEffect() {};
 };
 
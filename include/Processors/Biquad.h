@@ -0,0 +1,317 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_BIQUAD_HEADER_INCLUDED
+#define DSPTOOLS_BIQUAD_HEADER_INCLUDED
+
+#include <cmath>
+#include <vector>
+#include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** A second order IIR filter in transposed direct form II, with the responses of the RBJ
+    audio EQ cookbook and modulatable cutoff, Q and gain.
+    The parameters are read once every getUpdateInterval samples. The coefficients are only
+    recalculated when a parameter has changed since the last update, and then glide linearly
+    to their new values over the following interval, so modulation neither costs trig for every
+    sample nor steps the filter. Parameters set between setup and the first block take effect
+    immediately, and after that they are smoothed. The values of a1 and a2 that give a stable filter form a
+    triangle, so the filter stays stable as it glides between two stable settings. The channels
+    are filtered side by side in SIMD registers, with the state of each channel kept in arrays
+    across the channels.
+*/
+template <typename type>
+class Biquad : AudioEffect<type>
+{
+public:
+    enum Type {
+        lowPass = 0,
+        highPass = 1,
+        bandPass = 2,
+        notch = 3,
+        allPass = 4,
+        peak = 5,
+        lowShelf = 6,
+        highShelf = 7
+    };
+    
+    Biquad() {}
+    ~Biquad() {}
+    
+    /** Setup the filter. This must be called before calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        this->sampleRate = sampleRate;
+        
+        // The parameters are the same for every channel, so they are evaluated once per block.
+        cutoff.setup(sampleRate, 1, 1000.0, 0.05);
+        q.setup(sampleRate, 1, 0.70710678118654752, 0.05);
+        gain.setup(sampleRate, 1, 0.0, 0.05);
+        cutoff.setParameterRange(20.0, 20000.0);
+        q.setParameterRange(0.1, 20.0);
+        gain.setParameterRange(-24.0, 24.0);
+        
+        parameterBuffers.setup(3, maxBufferSize);
+        state.assign(2 * numChannels, 0.0);
+        isStarting = true;
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Process a buffer of audio with the filter.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(audioBuffer.getNumSamples() <= parameterBuffers.getNumSamples());
+        assert(2 * audioBuffer.getNumChannels() <= state.size());
+        int numSamples = audioBuffer.getNumSamples();
+        auto cutoffs = parameterBuffers.getChannelData(0);
+        auto qs = parameterBuffers.getChannelData(1);
+        auto gains = parameterBuffers.getChannelData(2);
+        bool isConstantCutoff = cutoff.fillBlock(0, cutoffs, numSamples, false);
+        bool isConstantQ = q.fillBlock(0, qs, numSamples, false);
+        bool isConstantGain = gain.fillBlock(0, gains, numSamples, false);
+        
+        for (int start = 0; start < numSamples; start += updateInterval) {
+            int length = std::min(updateInterval, numSamples - start);
+            int last = start + length - 1;
+            updateCoefficients(cutoffs[isConstantCutoff ? 0 : last], qs[isConstantQ ? 0 : last], gains[isConstantGain ? 0 : last], length);
+            auto block = audioBuffer.subBlock(start, length);
+            kernels->filterBiquads(block.getArrayOfChannels(), state.data(), static_cast<int> (block.getNumChannels()), length, coefficients, increments);
+            std::copy(targets, targets + numCoefficients, coefficients);
+        }
+    }
+    
+    /** Set the type of the filter response.
+    */
+    void setType(Type newType)
+    {
+        filterType = newType;
+        needsUpdate = true;
+    }
+    
+    /** Set the cutoff, or centre, frequency in Hz.
+    */
+    void setCutoff(type frequency, type modAmount = 0.0)
+    {
+        setParameter(cutoff, frequency, modAmount);
+    }
+    
+    /** Set the range of the cutoff parameter in Hz.
+    */
+    void setCutoffRange(type minFrequency, type maxFrequency)
+    {
+        cutoff.setParameterRange(minFrequency, maxFrequency);
+    }
+    
+    /** Set the Q, or resonance, of the filter.
+    */
+    void setQ(type qValue, type modAmount = 0.0)
+    {
+        setParameter(q, qValue, modAmount);
+    }
+    
+    /** Set the range of the Q parameter.
+    */
+    void setQRange(type minQ, type maxQ)
+    {
+        q.setParameterRange(minQ, maxQ);
+    }
+    
+    /** Set the gain in dB of the peak and shelf responses.
+    */
+    void setGain(type gainInDb, type modAmount = 0.0)
+    {
+        setParameter(gain, gainInDb, modAmount);
+    }
+    
+    /** Set the range of the gain parameter in dB.
+    */
+    void setGainRange(type minGainInDb, type maxGainInDb)
+    {
+        gain.setParameterRange(minGainInDb, maxGainInDb);
+    }
+    
+    /** Set the modulation source for the cutoff parameter.
+    */
+    void setCutoffModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
+    {
+        cutoff.setModulationSource(modulationSource);
+    }
+    
+    /** Set the modulation source for the Q parameter.
+    */
+    void setQModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
+    {
+        q.setModulationSource(modulationSource);
+    }
+    
+    /** Set the modulation source for the gain parameter.
+    */
+    void setGainModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
+    {
+        gain.setModulationSource(modulationSource);
+    }
+    
+    /** Set the number of samples between reading the parameters, which is also the time the
+        coefficients take to glide to new values. The default is 32.
+    */
+    void setUpdateInterval(int numSamples)
+    {
+        assert(numSamples > 0);
+        updateInterval = numSamples;
+    }
+    
+    int getUpdateInterval() const
+    {
+        return updateInterval;
+    }
+    
+    /** Clear the filter state of every channel.
+    */
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), type (0.0));
+    }
+    
+    /** Calculate b0, b1, b2, a1 and a2 for a response from the cookbook formulae, normalised
+        by a0, and write them to dest.
+    */
+    static void calculateCoefficients(Type filterType, double frequency, double qValue, double gainInDb, double sampleRate, type* dest)
+    {
+        frequency = std::min(frequency, 0.49 * sampleRate);
+        auto w0 = 2.0 * Maths<double>::pi * frequency / sampleRate;
+        auto cosW0 = std::cos(w0);
+        auto alpha = std::sin(w0) / (2.0 * qValue);
+        auto A = std::pow(10.0, gainInDb / 40.0);
+        auto shelf = 2.0 * std::sqrt(A) * alpha;
+        double b0 = 1.0, b1 = -2.0 * cosW0, b2 = 1.0, a0 = 1.0 + alpha, a1 = -2.0 * cosW0, a2 = 1.0 - alpha;
+        switch (filterType) {
+            case lowPass:
+                b0 = b2 = (1.0 - cosW0) / 2.0;
+                b1 = 1.0 - cosW0;
+                break;
+            case highPass:
+                b0 = b2 = (1.0 + cosW0) / 2.0;
+                b1 = -(1.0 + cosW0);
+                break;
+            case bandPass:
+                b0 = alpha;
+                b1 = 0.0;
+                b2 = -alpha;
+                break;
+            case notch:
+                break;
+            case allPass:
+                b0 = 1.0 - alpha;
+                b2 = 1.0 + alpha;
+                break;
+            case peak:
+                b0 = 1.0 + alpha * A;
+                b2 = 1.0 - alpha * A;
+                a0 = 1.0 + alpha / A;
+                a2 = 1.0 - alpha / A;
+                break;
+            case lowShelf:
+                b0 = A * ((A + 1.0) - (A - 1.0) * cosW0 + shelf);
+                b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosW0);
+                b2 = A * ((A + 1.0) - (A - 1.0) * cosW0 - shelf);
+                a0 = (A + 1.0) + (A - 1.0) * cosW0 + shelf;
+                a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosW0);
+                a2 = (A + 1.0) + (A - 1.0) * cosW0 - shelf;
+                break;
+            case highShelf:
+                b0 = A * ((A + 1.0) + (A - 1.0) * cosW0 + shelf);
+                b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosW0);
+                b2 = A * ((A + 1.0) + (A - 1.0) * cosW0 - shelf);
+                a0 = (A + 1.0) - (A - 1.0) * cosW0 + shelf;
+                a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosW0);
+                a2 = (A + 1.0) - (A - 1.0) * cosW0 - shelf;
+                break;
+            default:
+                break;
+        }
+        dest[0] = static_cast<type> (b0 / a0);
+        dest[1] = static_cast<type> (b1 / a0);
+        dest[2] = static_cast<type> (b2 / a0);
+        dest[3] = static_cast<type> (a1 / a0);
+        dest[4] = static_cast<type> (a2 / a0);
+    }
+    
+private:
+    static constexpr int numCoefficients = 5;
+    
+    /** Set a parameter, jumping straight to the value if no block has been processed since
+        setup so that the first block has the response that was asked for.
+    */
+    void setParameter(ModulationParameter<type>& parameter, type value, type modAmount)
+    {
+        if (isStarting) {
+            parameter.setCurrentAndTargetParameterValue(value, modAmount);
+        } else {
+            parameter.setParameterValue(value, modAmount);
+        }
+    }
+    
+    /** Set the targets and increments for the next length samples, recalculating the
+        coefficients only if a parameter has changed.
+    */
+    void updateCoefficients(type newCutoff, type newQ, type newGain, int length)
+    {
+        if (needsUpdate || newCutoff != lastCutoff || newQ != lastQ || newGain != lastGain) {
+            lastCutoff = newCutoff;
+            lastQ = newQ;
+            lastGain = newGain;
+            needsUpdate = false;
+            calculateCoefficients(filterType, lastCutoff, lastQ, lastGain, sampleRate, targets);
+        }
+        if (isStarting) {
+            // The first block starts on its coefficients rather than gliding from zero.
+            std::copy(targets, targets + numCoefficients, coefficients);
+            isStarting = false;
+        }
+        for (int index = 0; index < numCoefficients; ++index) {
+            increments[index] = (targets[index] - coefficients[index]) / length;
+        }
+    }
+    
+    ModulationParameter<type> cutoff, q, gain;
+    AlignedAudioBuffer<type> parameterBuffers;
+    std::vector<type> state;
+    type coefficients[numCoefficients] = {};
+    type targets[numCoefficients] = {};
+    type increments[numCoefficients] = {};
+    type lastCutoff = 0.0, lastQ = 0.0, lastGain = 0.0;
+    double sampleRate = 44100.0;
+    int updateInterval = 32;
+    Type filterType = lowPass;
+    bool needsUpdate = true;
+    bool isStarting = true;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_BIQUAD_HEADER_INCLUDED
@@ -23,7 +23,9 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_COMPRESSOR_HEADER_INCLUDED
 #define DSPTOOLS_COMPRESSOR_HEADER_INCLUDED
 
+#include "../Utilities/AlignedAudioBuffer.h"
 #include "../Utilities/EnvelopeFollower.h"
+#include "../Utilities/GainComputer.h"
 
 namespace DSPTools {
 
@@ -31,6 +33,16 @@ template <typename type>
 class Compressor : AudioEffect<type>
 {
 public:
+    /** How the detector is shared between channels.
+        Unlinked channels are compressed independently. Linked channels share one detector,
+        fed by the largest or the mean absolute sample across channels, and one gain.
+    */
+    enum LinkMode {
+        unlinked = 0,
+        linkedMaximum = 1,
+        linkedMean = 2
+    };
+    
     Compressor() {}
     ~Compressor() {}
     
@@ -39,33 +51,80 @@ public:
     void setup(double sampleRate, int maxBufferSize, int numChannels)
     {
         follower.setup(sampleRate, numChannels, EnvelopeFollower<type>::Mode::rms);
-        attack.setup(sampleRate, numChannels, 0.0, 0.05);
-        release.setup(sampleRate, numChannels, 0.0, 0.05);
-        threshold.setup(sampleRate, numChannels, 0.0, 0.05);
-        ratio.setup(sampleRate, numChannels, 1.0, 0.05);
-        knee.setup(sampleRate, numChannels, 0.0, 0.05);
+        
+        // The parameters are the same for every channel, so they are evaluated once per block.
+        attack.setup(sampleRate, 1, 0.0, 0.05);
+        release.setup(sampleRate, 1, 0.0, 0.05);
+        threshold.setup(sampleRate, 1, 0.0, 0.05);
+        ratio.setup(sampleRate, 1, 1.0, 0.05);
+        knee.setup(sampleRate, 1, 0.0, 0.05);
         
         attack.setParameterRange(0.00001, 0.5);
         release.setParameterRange(0.00001, 0.5);
         threshold.setParameterRange(-100.0, 0.0);
         ratio.setParameterRange(1.0, 20.0);
         knee.setParameterRange(0.0, 1.0);
+        
+        parameterBuffers.setup(5, maxBufferSize);
+        attackBuffer = parameterBuffers.getChannelData(0);
+        releaseBuffer = parameterBuffers.getChannelData(1);
+        thresholdBuffer = parameterBuffers.getChannelData(2);
+        ratioBuffer = parameterBuffers.getChannelData(3);
+        kneeBuffer = parameterBuffers.getChannelData(4);
+        
+        gainBuffers.setup(numChannels, maxBufferSize);
+        gainPointers = gainBuffers.getArrayOfChannels();
+        inputPointers.resize(numChannels);
+        kernels = &VectorOperations<type>::getBest();
     }
     
     /** Process a buffer of audio with the compressor.
+        All channels are processed together, one sample at a time, so that unlinked detectors
+        run side by side in SIMD registers.
     */
     void processAudio(AudioBufferInfo<type>& audioBuffer)
     {
-        for (int channel = 0; channel < audioBuffer.getNumChannels(); ++channel) {
-            auto data = audioBuffer.getChannelData(channel);
-            for (int sample = 0; sample < audioBuffer.getNumSamples(); ++sample) {
-                follower.setAttack(attack.getNextModulatedParameterValue(channel, sample));
-                follower.setRelease(release.getNextModulatedParameterValue(channel, sample));
-                data[sample] *= Maths<type>::decibelsToAmplitude(calcGain(ratio.getNextModulatedParameterValue(channel, sample), threshold.getNextModulatedParameterValue(channel, sample), Maths<type>::amplitudeToDecibels(follower.calculateEnvelope(data[sample], channel)), knee.getNextModulatedParameterValue(channel, sample)));
+        assert(audioBuffer.getNumSamples() <= parameterBuffers.getNumSamples());
+        int numSamples = audioBuffer.getNumSamples();
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        assert(numChannels <= gainBuffers.getNumChannels());
+        
+        bool isStaticTiming = attack.fillBlock(0, attackBuffer, numSamples);
+        isStaticTiming &= release.fillBlock(0, releaseBuffer, numSamples);
+        bool isStaticCurve = threshold.fillBlock(0, thresholdBuffer, numSamples);
+        isStaticCurve &= ratio.fillBlock(0, ratioBuffer, numSamples);
+        isStaticCurve &= knee.fillBlock(0, kneeBuffer, numSamples);
+        if (isStaticCurve) {
+            gainComputer.setParameters(thresholdBuffer[0], ratioBuffer[0], kneeBuffer[0]);
+        }
+        
+        int numDetectors = numChannels;
+        if (linkMode == unlinked) {
+            for (int channel = 0; channel < numChannels; ++channel) {
+                inputPointers[channel] = audioBuffer.getChannelData(channel);
             }
+        } else {
+            calculateLinkedInput(audioBuffer, numChannels, numSamples);
+            inputPointers[0] = gainPointers[0];
+            numDetectors = 1;
+        }
+        
+        calculateEnvelopes(numDetectors, numSamples, isStaticTiming);
+        for (int detector = 0; detector < numDetectors; ++detector) {
+            calculateGains(gainPointers[detector], numSamples, isStaticCurve);
+        }
+        for (int channel = 0; channel < numChannels; ++channel) {
+            kernels->multiply(audioBuffer.getChannelData(channel), gainPointers[linkMode == unlinked ? channel : 0], numSamples);
         }
     }
     
+    /** Set how the detector is shared between channels.
+    */
+    void setLinkMode(LinkMode newLinkMode)
+    {
+        linkMode = newLinkMode;
+    }
+    
     /** Set the envelope detection mode.
     */
     void setEnvelopeType(typename EnvelopeFollower<type>::Mode mode)
@@ -172,25 +231,80 @@ public:
     }
     
 private:
-    type calcGain(type ratio, type thresholdInDb, type envelopeInDb, type knee)
+    
+    /** Write the shared detector input to the first gain buffer.
+    */
+    void calculateLinkedInput(AudioBufferInfo<type>& audioBuffer, int numChannels, int numSamples)
     {
-        auto kneeWidth = thresholdInDb * knee * -1.0;
-        auto lowerKneeBound = thresholdInDb - (kneeWidth / 2.0);
-        auto upperKneeBound = thresholdInDb + (kneeWidth / 2.0);
-        auto slope = 1.0 - (1.0 / ratio);
-        
-        if (knee > 0.0 && envelopeInDb > lowerKneeBound && envelopeInDb < upperKneeBound) {
-            slope *= (((envelopeInDb - lowerKneeBound) / kneeWidth) * 0.5);
-            return slope * (lowerKneeBound - envelopeInDb);
-        } else
-        {
-            slope *= (thresholdInDb - envelopeInDb);
-            return std::min(0.0, slope);
+        auto linked = gainPointers[0];
+        auto first = audioBuffer.getChannelData(0);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            linked[sample] = std::abs(first[sample]);
+        }
+        for (int channel = 1; channel < numChannels; ++channel) {
+            auto data = audioBuffer.getChannelData(channel);
+            if (linkMode == linkedMaximum) {
+                for (int sample = 0; sample < numSamples; ++sample) {
+                    linked[sample] = std::max(linked[sample], type (std::abs(data[sample])));
+                }
+            } else {
+                for (int sample = 0; sample < numSamples; ++sample) {
+                    linked[sample] += std::abs(data[sample]);
+                }
+            }
+        }
+        if (linkMode == linkedMean) {
+            kernels->multiplyByValue(linked, type (1.0) / numChannels, numSamples);
+        }
+    }
+    
+    /** Follow the envelopes of the input pointers into the gain buffers.
+        Moving attack or release times are applied every sample, once for all channels.
+    */
+    void calculateEnvelopes(int numDetectors, int numSamples, bool isStaticTiming)
+    {
+        if (isStaticTiming) {
+            follower.setAttack(attackBuffer[0]);
+            follower.setRelease(releaseBuffer[0]);
+            follower.calculateEnvelopeBlock(inputPointers.data(), gainPointers, numDetectors, numSamples);
+            return;
+        }
+        for (int sample = 0; sample < numSamples; ++sample) {
+            follower.setAttack(attackBuffer[sample]);
+            follower.setRelease(releaseBuffer[sample]);
+            for (int detector = 0; detector < numDetectors; ++detector) {
+                gainPointers[detector][sample] = follower.calculateEnvelope(inputPointers[detector][sample], detector);
+            }
+        }
+    }
+    
+    /** Replace a block of envelope values with linear gains. A static curve is run over the
+        padded length of the gain buffer so the vector kernels need no scalar tail.
+    */
+    void calculateGains(type* data, int numSamples, bool isStaticCurve)
+    {
+        if (isStaticCurve) {
+            gainComputer.getGainAmplitudes(data, AlignedAudioBuffer<type>::getPaddedLength(numSamples));
+            return;
+        }
+        for (int sample = 0; sample < numSamples; ++sample) {
+            data[sample] = Maths<type>::decibelsToAmplitude(GainComputer<type>::calculateGain(ratioBuffer[sample], thresholdBuffer[sample], Maths<type>::amplitudeToDecibels(data[sample]), kneeBuffer[sample]));
         }
     }
     
     ModulationParameter<type> attack, release, threshold, ratio, knee;
+    AlignedAudioBuffer<type> parameterBuffers, gainBuffers;
+    type* attackBuffer = nullptr;
+    type* releaseBuffer = nullptr;
+    type* thresholdBuffer = nullptr;
+    type* ratioBuffer = nullptr;
+    type* kneeBuffer = nullptr;
+    type* const* gainPointers = nullptr;
+    std::vector<const type*> inputPointers;
+    LinkMode linkMode = unlinked;
+    const VectorOperations<type>* kernels = nullptr;
     EnvelopeFollower<type> follower;
+    GainComputer<type> gainComputer;
 };
 
 
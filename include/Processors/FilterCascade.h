@@ -0,0 +1,113 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_FILTER_CASCADE_HEADER_INCLUDED
+#define DSPTOOLS_FILTER_CASCADE_HEADER_INCLUDED
+
+#include <cmath>
+#include <vector>
+#include "AudioEffect.h"
+#include "Biquad.h"
+
+namespace DSPTools {
+
+/** A series of Biquad filters run one after another over each block, such as the bands of a
+    parametric EQ or a higher order low or high pass.
+*/
+template <typename type>
+class FilterCascade : AudioEffect<type>
+{
+public:
+    FilterCascade() {}
+    ~FilterCascade() {}
+    
+    /** Set the number of filters in the cascade. This must be called before setup.
+    */
+    void setNumFilters(int numFilters)
+    {
+        assert(numFilters > 0);
+        filters.resize(numFilters);
+    }
+    
+    /** Setup every filter in the cascade. This must be called before calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        for (auto& filter : filters) {
+            filter.setup(sampleRate, maxBufferSize, numChannels);
+        }
+    }
+    
+    /** Process a buffer of audio with each filter in turn.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        for (auto& filter : filters) {
+            filter.processAudio(audioBuffer);
+        }
+    }
+    
+    /** Make the cascade a Butterworth low or high pass of twice the number of filters in order,
+        by giving each filter the same cutoff and the Q of one pole pair. Called between setup
+        and the first block the response is exact from the first sample; called later the
+        filters glide to it as their parameters are smoothed.
+    */
+    void setButterworth(typename Biquad<type>::Type filterType, type frequency)
+    {
+        assert(filterType == Biquad<type>::lowPass || filterType == Biquad<type>::highPass);
+        int order = 2 * getNumFilters();
+        for (int index = 0; index < getNumFilters(); ++index) {
+            auto angle = Maths<double>::pi * (2 * index + 1) / (2.0 * order);
+            filters[index].setType(filterType);
+            filters[index].setCutoff(frequency);
+            filters[index].setQ(static_cast<type> (1.0 / (2.0 * std::cos(angle))));
+        }
+    }
+    
+    /** Clear the state of every filter.
+    */
+    void reset()
+    {
+        for (auto& filter : filters) {
+            filter.reset();
+        }
+    }
+    
+    /** Get one of the filters to set its parameters.
+    */
+    Biquad<type>& getFilter(int index)
+    {
+        return filters[index];
+    }
+    
+    int getNumFilters() const
+    {
+        return static_cast<int> (filters.size());
+    }
+    
+private:
+    std::vector<Biquad<type>> filters = std::vector<Biquad<type>>(1);
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_FILTER_CASCADE_HEADER_INCLUDED
@@ -24,6 +24,8 @@ SOFTWARE.*/
 #define DSPTOOLS_GAIN_HEADER_INCLUDED
 
 #include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
 
 namespace DSPTools {
 
@@ -40,25 +42,58 @@ public:
     {
         smoothedGain.setup(sampleRate, numChannels, 0.0, 0.05);
         setDecibelRange(-100.0, 0.0);
+        gainBuffer.setup(1, maxBufferSize);
+        kernels = &VectorOperations<type>::getBest();
     }
     
     /** Process a buffer of audio with the gain.
     */
     void processAudio(AudioBufferInfo<type>& audioBuffer)
     {
+        assert(audioBuffer.getNumSamples() <= gainBuffer.getNumSamples());
+        auto numSamples = audioBuffer.getNumSamples();
+        auto gains = gainBuffer.getChannelData(0);
         for (int channel = 0; channel < audioBuffer.getNumChannels(); ++channel) {
             auto data = audioBuffer.getChannelData(channel);
-            for (int sample = 0; sample < audioBuffer.getNumSamples(); ++sample) {
-                data[sample] *= smoothedGain.getNextModulatedParameterValue(channel, sample);
+            if (getGainBlock(channel, gains, numSamples)) {
+                kernels->multiplyByValue(data, gains[0], numSamples);
+            } else {
+                kernels->multiply(data, gains, numSamples);
             }
         }
     }
     
+    /** Fill a buffer with the gains for the next block of a channel without applying them.
+        Returns true if the gain is constant over the block, in which case only dest[0] is used.
+        A ProcessorChain uses this to combine neighbouring gain stages into one pass.
+    */
+    bool getGainBlock(int channel, type* dest, int numSamples)
+    {
+        return smoothedGain.fillBlock(channel, dest, numSamples, false);
+    }
+    
     /** Set the gain value in dBFS.
     */
     void setDecibels(type dB, type modAmount = 0.0)
     {
-        smoothedGain.setParameterValue((dB >= -100.0) ? Maths<type>::decibelsToAmplitude(dB) : 0.0, (modAmount < 0.0) ? sqrt(abs(modAmount)) * -1.0 : sqrt(modAmount));
+        smoothedGain.setParameterValue(toAmplitude(dB), toModulationDepth(modAmount));
+    }
+    
+    /** Set the gain value in dBFS, starting at a sample offset within the next block.
+        Returns false if the event could not be queued.
+    */
+    bool setDecibelsAtSample(int sampleOffset, type dB, type modAmount = 0.0)
+    {
+        return smoothedGain.addEvent(sampleOffset, toAmplitude(dB), toModulationDepth(modAmount));
+    }
+    
+    /** Set whether the gain moves to new values in linear or exponential ramps of amplitude.
+        The default is linear; exponential ramps sound more even over large changes in level.
+        This must be called after setup.
+    */
+    void setSmoothingMode(typename SmoothedValue<type>::Mode mode)
+    {
+        smoothedGain.setSmoothingMode(mode);
     }
     
     /** Set the range of the gain parameter in dBFS.
@@ -76,7 +111,19 @@ public:
     }
     
 private:
+    static type toAmplitude(type dB)
+    {
+        return (dB >= -100.0) ? Maths<type>::decibelsToAmplitude(dB) : 0.0;
+    }
+    
+    static type toModulationDepth(type modAmount)
+    {
+        return (modAmount < 0.0) ? sqrt(abs(modAmount)) * -1.0 : sqrt(modAmount);
+    }
+    
     ModulationParameter<type> smoothedGain;
+    AlignedAudioBuffer<type> gainBuffer;
+    const VectorOperations<type>* kernels = nullptr;
 };
 
 } // namespace DSPTools
@@ -0,0 +1,209 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_LIMITER_HEADER_INCLUDED
+#define DSPTOOLS_LIMITER_HEADER_INCLUDED
+
+#include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/EnvelopeFollower.h"
+#include "../Utilities/SlidingWindowMaximum.h"
+#include "../Utilities/TruePeakDetector.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** A brickwall lookahead limiter. All channels share one gain.
+    The detector is held over the lookahead window with a sliding window maximum, released
+    with an EnvelopeFollower and then averaged over the same window. The gain is therefore
+    fully reduced by the time a peak leaves the delay line and the output never exceeds the
+    ceiling. The audio is delayed by getLatencyInSamples samples.
+*/
+template <typename type>
+class Limiter : AudioEffect<type>
+{
+public:
+    Limiter() {}
+    ~Limiter() {}
+    
+    /** Setup the limiter. This must be called before calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        this->sampleRate = sampleRate;
+        auto maxLatency = static_cast<int> (std::ceil(maxLookahead * sampleRate)) + TruePeakDetector<type>::getLatencyInSamples();
+        
+        follower.setup(sampleRate, 1, EnvelopeFollower<type>::Mode::peak);
+        follower.setAttack(0.00001);
+        follower.setRelease(release);
+        peakHold.setup(maxLatency + 1);
+        truePeakDetector.setup(numChannels);
+        
+        smoothingBuffer.resize(maxLatency + 1);
+        gainBuffer.setup(1, maxBufferSize);
+        delayLines.setup(numChannels, maxLatency);
+        kernels = &VectorOperations<type>::getBest();
+        reset();
+    }
+    
+    /** Process a buffer of audio with the limiter.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(audioBuffer.getNumSamples() <= gainBuffer.getNumSamples());
+        int numSamples = audioBuffer.getNumSamples();
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        assert(numChannels <= delayLines.getNumChannels());
+        auto gains = gainBuffer.getChannelData(0);
+        
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto data = audioBuffer.getChannelData(channel);
+            for (int sample = 0; sample < numSamples; ++sample) {
+                type level = isTruePeak ? truePeakDetector.process(data[sample], channel) : std::abs(data[sample]);
+                gains[sample] = (channel == 0) ? level : std::max(gains[sample], level);
+            }
+        }
+        for (int sample = 0; sample < numSamples; ++sample) {
+            gains[sample] = calculateGain(gains[sample]);
+        }
+        
+        int latency = getLatencyInSamples();
+        int position = delayPosition;
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto data = audioBuffer.getChannelData(channel);
+            if (latency > 0) {
+                auto delayLine = delayLines.getChannelData(channel);
+                position = delayPosition;
+                for (int sample = 0; sample < numSamples; ++sample) {
+                    auto delayed = delayLine[position];
+                    delayLine[position] = data[sample];
+                    data[sample] = delayed;
+                    if (++position == latency) {
+                        position = 0;
+                    }
+                }
+            }
+            kernels->multiply(data, gains, numSamples);
+        }
+        delayPosition = position;
+    }
+    
+    /** Get the delay the limiter adds to the audio in samples.
+    */
+    int getLatencyInSamples()
+    {
+        return lookaheadInSamples + (isTruePeak ? TruePeakDetector<type>::getLatencyInSamples() : 0);
+    }
+    
+    /** Set the ceiling in dBFS.
+    */
+    void setCeiling(type ceilingInDb)
+    {
+        ceiling = Maths<type>::decibelsToAmplitude(ceilingInDb);
+    }
+    
+    /** Set the release time in seconds.
+    */
+    void setRelease(type time)
+    {
+        release = std::max(type (0.00001), time);
+        follower.setRelease(release);
+    }
+    
+    /** Set the lookahead time in seconds, up to maxLookahead.
+        This changes the latency and resets the limiter, so it should not be automated.
+    */
+    void setLookahead(type time)
+    {
+        assert(time >= 0.0 && time <= maxLookahead);
+        lookahead = time;
+        reset();
+    }
+    
+    /** Detect the peaks between samples as well as the samples themselves.
+        This adds the latency of the TruePeakDetector and resets the limiter.
+    */
+    void setTruePeakDetection(bool shouldDetectTruePeaks)
+    {
+        isTruePeak = shouldDetectTruePeaks;
+        reset();
+    }
+    
+    /** Clear the delay lines and the gain reduction.
+    */
+    void reset()
+    {
+        lookaheadInSamples = static_cast<int> (std::round(lookahead * sampleRate));
+        int windowSize = lookaheadInSamples + 1;
+        if (smoothingBuffer.empty()) {
+            return;
+        }
+        peakHold.setWindowSize(windowSize);
+        truePeakDetector.reset();
+        smoothingLength = windowSize;
+        smoothingPosition = 0;
+        std::fill(smoothingBuffer.begin(), smoothingBuffer.end(), type (1.0));
+        smoothingSum = smoothingLength;
+        delayLines.clear();
+        delayPosition = 0;
+    }
+    
+    static constexpr double maxLookahead = 0.02;
+    
+private:
+    
+    /** Convert one detector value into the gain for the sample leaving the delay line.
+    */
+    type calculateGain(type level)
+    {
+        auto held = peakHold.process(level);
+        auto envelope = std::max(held, follower.calculateEnvelope(held, 0));
+        type target = (envelope > ceiling) ? ceiling / envelope : type (1.0);
+        
+        // The running sum is recalculated once per window so rounding errors cannot build up.
+        smoothingSum += target - smoothingBuffer[smoothingPosition];
+        smoothingBuffer[smoothingPosition] = target;
+        if (++smoothingPosition == smoothingLength) {
+            smoothingPosition = 0;
+            smoothingSum = 0.0;
+            for (int point = 0; point < smoothingLength; ++point) {
+                smoothingSum += smoothingBuffer[point];
+            }
+        }
+        return static_cast<type> (smoothingSum / smoothingLength);
+    }
+    
+    EnvelopeFollower<type> follower;
+    SlidingWindowMaximum<type> peakHold;
+    TruePeakDetector<type> truePeakDetector;
+    AlignedAudioBuffer<type> delayLines, gainBuffer;
+    std::vector<type> smoothingBuffer;
+    double sampleRate = 44100.0, smoothingSum = 0.0;
+    type ceiling = 1.0, release = 0.05, lookahead = 0.005;
+    int lookaheadInSamples = 0, smoothingLength = 1, smoothingPosition = 0, delayPosition = 0;
+    bool isTruePeak = false;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_LIMITER_HEADER_INCLUDED
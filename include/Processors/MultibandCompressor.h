@@ -0,0 +1,245 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_MULTIBAND_COMPRESSOR_HEADER_INCLUDED
+#define DSPTOOLS_MULTIBAND_COMPRESSOR_HEADER_INCLUDED
+
+#include <cmath>
+#include <vector>
+#include "AudioEffect.h"
+#include "Biquad.h"
+#include "Compressor.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** Splits the audio into bands with Linkwitz-Riley crossovers, compresses each band with its
+    own Compressor, and sums the bands back together.
+    Each crossover is a fourth order Linkwitz-Riley low and high pass, made of two Butterworth
+    biquads. A band below a crossover it was not split by is passed through the matching all
+    pass, so the bands stay in phase and sum back to a flat response. Every band and channel
+    has its own chain of biquads, and all the chains run in one pass over the block with the
+    bands and channels side by side in SIMD registers. Each band's compressor then follows its
+    channels together in the same way. When a crossover moves, the coefficients glide linearly
+    to their new values over the next block, as Biquad's do, so the filters stay stable and do
+    not step.
+*/
+template <typename type>
+class MultibandCompressor : AudioEffect<type>
+{
+public:
+    MultibandCompressor() {}
+    ~MultibandCompressor() {}
+    
+    /** Set the number of bands, which is one more than the number of crossovers. The crossovers
+        are spread evenly in pitch from 100 Hz to 10 kHz. This must be called before setup.
+    */
+    void setNumBands(int numBands)
+    {
+        assert(numBands > 1);
+        bands.resize(numBands);
+        crossovers.resize(numBands - 1);
+        for (int index = 0; index < numBands - 1; ++index) {
+            crossovers[index] = (numBands == 2) ? 1000.0 : 100.0 * std::pow(100.0, index / (numBands - 2.0));
+        }
+    }
+    
+    /** Setup the crossovers and the compressor of every band. This must be called before
+        calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        this->sampleRate = sampleRate;
+        this->numChannels = numChannels;
+        for (auto& band : bands) {
+            band.setup(sampleRate, maxBufferSize, numChannels);
+        }
+        
+        // The lanes are padded to whole registers with silent lanes whose coefficients are zero.
+        kernels = &VectorOperations<type>::getBest();
+        int numBands = getNumBands();
+        numLanes = numBands * numChannels;
+        numLanes += (kernels->vectorSize - numLanes % kernels->vectorSize) % kernels->vectorSize;
+        numStages = 2 * (numBands - 1);
+        bandBuffers.setup(numLanes, maxBufferSize);
+        coefficients.assign(5 * numStages * numLanes, 0.0);
+        targets.assign(5 * numStages * numLanes, 0.0);
+        increments.assign(5 * numStages * numLanes, 0.0);
+        state.assign(2 * numStages * numLanes, 0.0);
+        silence.setup(1, maxBufferSize);
+        inputPointers.resize(numLanes);
+        std::fill(inputPointers.begin(), inputPointers.end(), silence.getChannelData(0));
+        needsUpdate = true;
+        isStarting = true;
+    }
+    
+    /** Process a buffer of audio with the multiband compressor.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(audioBuffer.getNumSamples() <= bandBuffers.getNumSamples());
+        int numSamples = audioBuffer.getNumSamples();
+        int numBufferChannels = static_cast<int> (audioBuffer.getNumChannels());
+        assert(numBufferChannels <= numChannels);
+        int numBands = getNumBands();
+        bool isRamping = false;
+        if (needsUpdate) {
+            calculateCoefficients();
+            isRamping = !isStarting && numSamples > 0;
+            if (isRamping) {
+                for (int index = 0; index < static_cast<int> (targets.size()); ++index) {
+                    increments[index] = (targets[index] - coefficients[index]) / numSamples;
+                }
+            } else {
+                // The first block starts on its coefficients rather than gliding from zero.
+                std::copy(targets.begin(), targets.end(), coefficients.begin());
+            }
+        }
+        isStarting = false;
+        
+        // Every band of a channel filters the same input. Channels the buffer does not have are
+        // fed silence, so every lane keeps its place in the coefficient table.
+        for (int band = 0; band < numBands; ++band) {
+            for (int channel = 0; channel < numChannels; ++channel) {
+                inputPointers[band * numChannels + channel] = (channel < numBufferChannels) ? audioBuffer.getChannelData(channel) : silence.getChannelData(0);
+            }
+        }
+        kernels->filterBiquadCascades(inputPointers.data(), bandBuffers.getArrayOfChannels(), state.data(), numLanes, numSamples, coefficients.data(), isRamping ? increments.data() : nullptr, numStages);
+        if (isRamping) {
+            std::copy(targets.begin(), targets.end(), coefficients.begin());
+        }
+        
+        for (int band = 0; band < numBands; ++band) {
+            AudioBufferInfo<type> bandBuffer(bandBuffers.getArrayOfChannels() + band * numChannels, numBufferChannels, numSamples);
+            bands[band].processAudio(bandBuffer);
+        }
+        for (int channel = 0; channel < numBufferChannels; ++channel) {
+            auto data = audioBuffer.getChannelData(channel);
+            std::copy(bandBuffers.getChannelData(channel), bandBuffers.getChannelData(channel) + numSamples, data);
+            for (int band = 1; band < numBands; ++band) {
+                kernels->addScaled(data, bandBuffers.getChannelData(band * numChannels + channel), 1.0, numSamples);
+            }
+        }
+    }
+    
+    /** Set the frequency in Hz of a crossover, counting up from the lowest. The crossovers
+        should be kept in rising order. The filters are recalculated at the start of the next
+        block and glide to their new settings over that block.
+    */
+    void setCrossoverFrequency(int index, type frequency)
+    {
+        assert(index >= 0 && index < static_cast<int> (crossovers.size()));
+        crossovers[index] = frequency;
+        needsUpdate = true;
+    }
+    
+    type getCrossoverFrequency(int index) const
+    {
+        return static_cast<type> (crossovers[index]);
+    }
+    
+    /** Get the compressor of a band, counting up from the lowest, to set its parameters.
+    */
+    Compressor<type>& getBand(int index)
+    {
+        return bands[index];
+    }
+    
+    int getNumBands() const
+    {
+        return static_cast<int> (bands.size());
+    }
+    
+    /** Clear the state of the crossover filters.
+    */
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), type (0.0));
+    }
+    
+private:
+    /** Fill the table of target coefficients. The chain of a band is the high passes of the
+        crossovers below it, the low pass of the crossover above it, and an all pass for each
+        crossover further up. Unused stages at the end of a chain pass the audio through
+        unchanged.
+    */
+    void calculateCoefficients()
+    {
+        int numBands = getNumBands();
+        auto butterworthQ = 1.0 / std::sqrt(2.0);
+        type stage[5];
+        for (int band = 0; band < numBands; ++band) {
+            int position = 0;
+            auto addStage = [&] (typename Biquad<type>::Type filterType, double frequency) {
+                Biquad<type>::calculateCoefficients(filterType, frequency, butterworthQ, 0.0, sampleRate, stage);
+                setStage(band, position++, stage);
+            };
+            for (int crossover = 0; crossover < band; ++crossover) {
+                addStage(Biquad<type>::highPass, crossovers[crossover]);
+                addStage(Biquad<type>::highPass, crossovers[crossover]);
+            }
+            if (band < numBands - 1) {
+                addStage(Biquad<type>::lowPass, crossovers[band]);
+                addStage(Biquad<type>::lowPass, crossovers[band]);
+            }
+            for (int crossover = band + 1; crossover < numBands - 1; ++crossover) {
+                addStage(Biquad<type>::allPass, crossovers[crossover]);
+            }
+            type passThrough[5] = { 1.0, 0.0, 0.0, 0.0, 0.0 };
+            while (position < numStages) {
+                setStage(band, position++, passThrough);
+            }
+        }
+        needsUpdate = false;
+    }
+    
+    /** Copy the target coefficients of one stage to the lanes of every channel of a band.
+    */
+    void setStage(int band, int position, const type* stage)
+    {
+        for (int channel = 0; channel < numChannels; ++channel) {
+            int lane = band * numChannels + channel;
+            for (int index = 0; index < 5; ++index) {
+                targets[(5 * position + index) * numLanes + lane] = stage[index];
+            }
+        }
+    }
+    
+    std::vector<Compressor<type>> bands = std::vector<Compressor<type>>(4);
+    std::vector<double> crossovers = { 100.0, 1000.0, 10000.0 };
+    AlignedAudioBuffer<type> bandBuffers, silence;
+    std::vector<type> coefficients, targets, increments, state;
+    std::vector<const type*> inputPointers;
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int numLanes = 0;
+    int numStages = 0;
+    bool needsUpdate = true;
+    bool isStarting = true;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_MULTIBAND_COMPRESSOR_HEADER_INCLUDED
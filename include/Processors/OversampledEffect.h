@@ -0,0 +1,142 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_OVERSAMPLED_EFFECT_HEADER_INCLUDED
+#define DSPTOOLS_OVERSAMPLED_EFFECT_HEADER_INCLUDED
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "AudioEffect.h"
+#include "../Modulation/ModulationSource.h"
+#include "../Utilities/Oversampler.h"
+
+namespace DSPTools {
+
+/** Runs an audio effect at 2, 4, 8 or 16 times the sample rate, e.g.
+    OversampledEffect<float, Compressor<float>>. The effect is set up with the higher sample
+    rate and block size, so its own times and filters stay correct, and each block is
+    upsampled, processed and downsampled with an Oversampler.
+    The effect renders blocks of the higher length, so the modulation sources of its parameters
+    must run at the higher rate too. Add each of them with addModulationSource, which sets it up
+    for the higher rate and block size and starts its blocks. A source that runs at the base rate
+    cannot feed the effect, as its buffer is shorter than the effect's blocks.
+*/
+template <typename type, typename Effect>
+class OversampledEffect : AudioEffect<type>
+{
+public:
+    OversampledEffect() {}
+    ~OversampledEffect() {}
+    
+    /** Set the number of 2x oversampling stages, from 1 to 4 for 2x to 16x. The default is 2,
+        for 4x. This must be called before setup.
+    */
+    void setNumStages(int numStages)
+    {
+        assert(numStages >= 1 && numStages <= Oversampler<type>::maxStages);
+        this->numStages = numStages;
+    }
+    
+    /** Add a modulation source that feeds parameters of the effect. The source is set up by
+        setup at the higher sample rate and block size, and processAudio starts each of its blocks,
+        so nothing else should set it up or call prepareModulationBuffer on it. This must be called
+        before setup.
+    */
+    void addModulationSource(std::shared_ptr<ModulationSource<type>> source)
+    {
+        modulationSources.push_back(std::move(source));
+    }
+    
+    /** Setup the oversampler, the effect and its modulation sources. This must be called before
+        calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        oversampler.setup(numStages, maxBufferSize, numChannels);
+        auto factor = oversampler.getOversamplingFactor();
+        for (auto& source : modulationSources) {
+            source->setup(maxBufferSize * factor, sampleRate * factor);
+        }
+        effect.setup(sampleRate * factor, maxBufferSize * factor, numChannels);
+    }
+    
+    /** Process a buffer of audio with the effect at the higher sample rate.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        auto oversampledBuffer = oversampler.upsample(audioBuffer);
+        for (auto& source : modulationSources) {
+            source->prepareModulationBuffer(oversampledBuffer.getNumSamples());
+        }
+        effect.processAudio(oversampledBuffer);
+        oversampler.downsample(audioBuffer);
+    }
+    
+    /** Clear the history of the oversampling filters.
+    */
+    void reset()
+    {
+        oversampler.reset();
+    }
+    
+    /** Get the delay of the oversampling filters and the effect in samples at the base rate.
+        The latency of the effect is rounded to the nearest base rate sample.
+    */
+    int getLatencyInSamples()
+    {
+        auto factor = oversampler.getOversamplingFactor();
+        return oversampler.getLatencyInSamples() + (getEffectLatency() + factor / 2) / factor;
+    }
+    
+    /** Get the effect to set its parameters.
+    */
+    Effect& getEffect()
+    {
+        return effect;
+    }
+    
+private:
+    template <typename EffectType, typename = void>
+    struct hasLatency : std::false_type {};
+    
+    template <typename EffectType>
+    struct hasLatency<EffectType, std::void_t<decltype(std::declval<EffectType&>().getLatencyInSamples())>> : std::true_type {};
+    
+    int getEffectLatency()
+    {
+        if constexpr (hasLatency<Effect>::value) {
+            return effect.getLatencyInSamples();
+        } else {
+            return 0;
+        }
+    }
+    
+    Effect effect;
+    Oversampler<type> oversampler;
+    std::vector<std::shared_ptr<ModulationSource<type>>> modulationSources;
+    int numStages = 2;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_OVERSAMPLED_EFFECT_HEADER_INCLUDED
@@ -24,6 +24,8 @@ SOFTWARE.*/
 #define DSPTOOLS_PANNER_HEADER_INCLUDED
 
 #include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
 
 namespace DSPTools {
 
@@ -40,22 +42,38 @@ public:
     {
         smoothedPanner.setup(sampleRate, numChannels, 0.0, 0.05);
         smoothedPanner.setParameterRange(-1.0, 1.0);
+        panBuffer.setup(1, maxBufferSize);
+        kernels = &VectorOperations<type>::getBest();
     }
     
     /** Process a buffer of audio with the panner.
     */
     void processAudio(AudioBufferInfo<type>& audioBuffer)
     {
+        assert(audioBuffer.getNumSamples() <= panBuffer.getNumSamples());
+        auto numSamples = audioBuffer.getNumSamples();
+        auto gains = panBuffer.getChannelData(0);
         for (int channel = 0; channel < audioBuffer.getNumChannels(); ++channel) {
             auto data = audioBuffer.getChannelData(channel);
-            for (int sample = 0; sample < audioBuffer.getNumSamples(); ++sample) {
-                auto panPosition = smoothedPanner.getNextModulatedParameterValue(channel, sample);
-                auto amp = calculateAmplitude(panPosition);
-                data[sample] *= (channel == 0) ? sqrt(1.0 - amp) : sqrt(amp);
+            if (getGainBlock(channel, gains, numSamples)) {
+                kernels->multiplyByValue(data, gains[0], numSamples);
+            } else {
+                kernels->multiply(data, gains, numSamples);
             }
         }
     }
     
+    /** Fill a buffer with the panning gains for the next block of a channel without applying them.
+        Returns true if the gain is constant over the block, in which case only dest[0] is used.
+        A ProcessorChain uses this to combine neighbouring gain stages into one pass.
+    */
+    bool getGainBlock(int channel, type* dest, int numSamples)
+    {
+        bool isConstant = smoothedPanner.fillBlock(channel, dest, numSamples, false);
+        kernels->panPositionsToGains(dest, isConstant ? 1 : numSamples, channel == 0);
+        return isConstant;
+    }
+    
     /** Set the pan value from -1 to 1.
     */
     void setPanning(type panPos0to1, type modAmount = 0.0)
@@ -63,6 +81,14 @@ public:
         smoothedPanner.setParameterValue(panPos0to1, modAmount);
     }
     
+    /** Set the pan value from -1 to 1, starting at a sample offset within the next block.
+        Returns false if the event could not be queued.
+    */
+    bool setPanningAtSample(int sampleOffset, type panPos0to1, type modAmount = 0.0)
+    {
+        return smoothedPanner.addEvent(sampleOffset, panPos0to1, modAmount);
+    }
+    
     /** Set the modulation source for the pan parameter.
     */
     void setPannerModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
@@ -71,12 +97,9 @@ public:
     }
     
 private:
-    type calculateAmplitude(type panPosition)
-    {
-        return panPosition / 2.0 + 0.5;
-    }
-    
     ModulationParameter<type> smoothedPanner;
+    AlignedAudioBuffer<type> panBuffer;
+    const VectorOperations<type>* kernels = nullptr;
 };
 
 } // namespace DSPTools
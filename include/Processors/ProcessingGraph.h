@@ -0,0 +1,461 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_PROCESSING_GRAPH_HEADER_INCLUDED
+#define DSPTOOLS_PROCESSING_GRAPH_HEADER_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+#include "../Utilities/WorkStealingQueue.h"
+
+namespace DSPTools {
+
+/** Runs audio effects connected in a directed acyclic graph, spreading independent branches
+    over a fixed pool of worker threads.
+ 
+    Each node processes its own buffer. Before it runs, the buffer is filled with the sum of
+    the outputs of the nodes connected to it, each scaled by the gain of its connection, so a
+    connection is both a send and a summing bus. The graph input and output are the
+    ProcessingGraph::input and ProcessingGraph::output pseudo nodes.
+ 
+    Nodes in parallel branches may share a ModulationSource, which is calculated once per block
+    by whichever node reads it first. Start the source's block with prepareModulationBuffer
+    before calling processAudio rather than from inside a node.
+ 
+    prepare() sorts the nodes and builds the schedule, and must be called from a non-audio
+    thread whenever nodes or connections change, while processAudio is not running. In
+    processAudio the audio thread queues the nodes with no dependencies and then works
+    alongside the pool: each thread runs nodes from its own work stealing queue, steals from
+    the others when it runs dry, and queues any node whose last dependency it has just
+    finished. A single atomic count of unfinished nodes is the completion barrier, which each
+    node passes with one wait-free decrement. Nothing blocks or allocates on the audio thread.
+    A worker with nothing to run yields, so it gives way to the audio thread when there are
+    more threads than cores, while the audio thread itself only spins. Between blocks the
+    workers wait briefly and then park on a condition variable, so an idle graph uses no CPU.
+    When a worker is parked the audio thread wakes it at the start of the next block, with a
+    try_lock that never waits and a notify, which is a system call but does not block.
+*/
+template <typename type>
+class ProcessingGraph : AudioEffect<type>
+{
+public:
+    static constexpr int input = -1;
+    static constexpr int output = -2;
+    
+    ProcessingGraph() {}
+    ~ProcessingGraph()
+    {
+        stopWorkers();
+    }
+    
+    /** Set the number of worker threads, not counting the audio thread. This takes effect in the
+        next call to setup. The default is one less than the number of hardware threads.
+    */
+    void setNumWorkerThreads(int newNumWorkers)
+    {
+        assert(newNumWorkers >= 0);
+        numWorkers = newNumWorkers;
+    }
+    
+    /** Set a function that each worker thread calls with its index, from 1, when it starts and
+        before it runs any node. Real-time priority and affinity are platform specific, so the
+        workers run at the default priority unless this function sets them, e.g. with
+        pthread_setschedparam on the calling thread. This takes effect in the next call to setup.
+    */
+    void setWorkerThreadSetup(std::function<void(int)> newSetup)
+    {
+        workerThreadSetup = std::move(newSetup);
+    }
+    
+    /** Get the number of worker threads that were started by setup.
+    */
+    int getNumWorkerThreads() const
+    {
+        return static_cast<int> (workers.size());
+    }
+    
+    /** Get a worker thread started by setup, from 1 to getNumWorkerThreads(), e.g. for its
+        native_handle.
+    */
+    std::thread& getWorkerThread(int worker)
+    {
+        assert(worker >= 1 && worker <= getNumWorkerThreads());
+        return workers[worker - 1];
+    }
+    
+    /** Setup the graph and start the worker threads. This must be called before calling prepare.
+        The effects in the graph are not setup by the graph and must be set up by their owner
+        with the same buffer size and channel count.
+    */
+    void setup(double /*sampleRate*/, int maxBufferSize, int numChannels)
+    {
+        stopWorkers();
+        this->maxBufferSize = maxBufferSize;
+        this->numChannels = numChannels;
+        kernels = &VectorOperations<type>::getBest();
+        queues.reset(new WorkStealingQueue[numWorkers + 1]);
+        isRunning.store(true);
+        for (int worker = 1; worker <= numWorkers; ++worker) {
+            workers.emplace_back([this, worker] { runWorker(worker); });
+        }
+        isPrepared = false;
+    }
+    
+    /** Add an effect to the graph and return its node index. The graph does not own the effect,
+        which must outlive it. Any type with a processAudio(AudioBufferInfo<type>&) method
+        can be a node.
+    */
+    template <typename Effect>
+    int addNode(Effect& effect)
+    {
+        waitForWorkers();
+        auto node = std::make_unique<Node>();
+        node->process = [&effect] (AudioBufferInfo<type>& buffer) { effect.processAudio(buffer); };
+        nodes.push_back(std::move(node));
+        isPrepared = false;
+        return static_cast<int> (nodes.size()) - 1;
+    }
+    
+    /** Add the output of one node, scaled by a gain, to the input of another. The source may be
+        ProcessingGraph::input and the destination may be ProcessingGraph::output.
+    */
+    void connect(int source, int destination, type gain = 1.0)
+    {
+        assert(source == input || (source >= 0 && source < static_cast<int> (nodes.size())));
+        assert(destination == output || (destination >= 0 && destination < static_cast<int> (nodes.size())));
+        waitForWorkers();
+        if (destination == output) {
+            outputConnections.push_back({source, gain});
+        } else {
+            nodes[destination]->inputs.push_back({source, gain});
+        }
+        isPrepared = false;
+    }
+    
+    /** Remove every node and connection.
+    */
+    void clear()
+    {
+        waitForWorkers();
+        nodes.clear();
+        outputConnections.clear();
+        rootNodes.clear();
+        isPrepared = false;
+    }
+    
+    /** Sort the nodes, allocate their buffers and build the schedule. This allocates, so call it
+        from a non-audio thread. Returns false if the connections contain a cycle, in which case
+        the graph stays unprepared and processAudio leaves the audio untouched.
+    */
+    bool prepare()
+    {
+        assert(maxBufferSize > 0);
+        waitForWorkers();
+        isPrepared = false;
+        int numNodes = static_cast<int> (nodes.size());
+        for (auto& node : nodes) {
+            node->successors.clear();
+            node->numDependencies = 0;
+        }
+        for (int index = 0; index < numNodes; ++index) {
+            for (auto& connection : nodes[index]->inputs) {
+                if (connection.source != input) {
+                    nodes[connection.source]->successors.push_back(index);
+                    ++nodes[index]->numDependencies;
+                }
+            }
+        }
+        rootNodes.clear();
+        std::vector<int> order;
+        std::vector<int> remainingDependencies(numNodes);
+        for (int index = 0; index < numNodes; ++index) {
+            remainingDependencies[index] = nodes[index]->numDependencies;
+            if (remainingDependencies[index] == 0) {
+                order.push_back(index);
+                rootNodes.push_back(index);
+            }
+        }
+        for (int position = 0; position < static_cast<int> (order.size()); ++position) {
+            for (int successor : nodes[order[position]]->successors) {
+                if (--remainingDependencies[successor] == 0) {
+                    order.push_back(successor);
+                }
+            }
+        }
+        if (static_cast<int> (order.size()) != numNodes) {
+            return false;
+        }
+        for (auto& node : nodes) {
+            node->buffer.setup(numChannels, maxBufferSize);
+        }
+        for (int queue = 0; queue <= numWorkers; ++queue) {
+            queues[queue].setup(numNodes);
+        }
+        isPrepared = true;
+        return true;
+    }
+    
+    /** Process a buffer of audio through the graph. The buffer holds the graph input and is
+        replaced by the graph output.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        if (!isPrepared) {
+            return;
+        }
+        assert(audioBuffer.getNumSamples() <= maxBufferSize);
+        assert(static_cast<int> (audioBuffer.getNumChannels()) == numChannels);
+        graphInput = &audioBuffer;
+        numSamples = audioBuffer.getNumSamples();
+        for (auto& node : nodes) {
+            node->pendingDependencies.store(node->numDependencies, std::memory_order_relaxed);
+        }
+        unfinishedNodes.store(static_cast<int> (nodes.size()), std::memory_order_relaxed);
+        for (int node : rootNodes) {
+            queues[0].push(node);
+        }
+        block.fetch_add(1, std::memory_order_seq_cst);
+        if (parkedWorkers.load(std::memory_order_seq_cst) > 0) {
+            wakeWorkers();
+        }
+        while (unfinishedNodes.load(std::memory_order_acquire) > 0) {
+            if (!runAvailableNode(0)) {
+                pause();
+            }
+        }
+        writeOutput(audioBuffer);
+    }
+    
+private:
+    struct Connection
+    {
+        int source;
+        type gain;
+    };
+    
+    struct Node
+    {
+        std::function<void(AudioBufferInfo<type>&)> process;
+        std::vector<Connection> inputs;
+        std::vector<int> successors;
+        int numDependencies = 0;
+        std::atomic<int> pendingDependencies {0};
+        AlignedAudioBuffer<type> buffer;
+    };
+    
+    type* getSourceChannel(int source, int channel)
+    {
+        return source == input ? graphInput->getChannelData(channel) : nodes[source]->buffer.getChannelData(channel);
+    }
+    
+    /** Run a node from the thread's own queue, or one stolen from another thread.
+        Returns false if there was no work to take.
+    */
+    bool runAvailableNode(int queue)
+    {
+        int node;
+        if (!queues[queue].pop(node)) {
+            bool stolen = false;
+            for (int offset = 1; offset <= numWorkers && !stolen; ++offset) {
+                stolen = queues[(queue + offset) % (numWorkers + 1)].steal(node);
+            }
+            if (!stolen) {
+                return false;
+            }
+        }
+        runNode(node, queue);
+        return true;
+    }
+    
+    void runNode(int index, int queue)
+    {
+        auto& node = *nodes[index];
+        for (int channel = 0; channel < numChannels; ++channel) {
+            type* dest = node.buffer.getChannelData(channel);
+            std::fill(dest, dest + numSamples, type(0));
+            for (auto& connection : node.inputs) {
+                kernels->addScaled(dest, getSourceChannel(connection.source, channel), connection.gain, numSamples);
+            }
+        }
+        auto bufferInfo = node.buffer.getBufferInfo(numSamples);
+        node.process(bufferInfo);
+        for (int successor : node.successors) {
+            if (nodes[successor]->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                queues[queue].push(successor);
+            }
+        }
+        unfinishedNodes.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    
+    /** Sum the connections to the graph output into the buffer. Connections straight from the
+        graph input scale the buffer in place before the node outputs are added.
+    */
+    void writeOutput(AudioBufferInfo<type>& audioBuffer)
+    {
+        type inputGain = 0;
+        for (auto& connection : outputConnections) {
+            if (connection.source == input) {
+                inputGain += connection.gain;
+            }
+        }
+        for (int channel = 0; channel < numChannels; ++channel) {
+            type* dest = audioBuffer.getChannelData(channel);
+            kernels->multiplyByValue(dest, inputGain, numSamples);
+            for (auto& connection : outputConnections) {
+                if (connection.source != input) {
+                    kernels->addScaled(dest, nodes[connection.source]->buffer.getChannelData(channel), connection.gain, numSamples);
+                }
+            }
+        }
+    }
+    
+    /** Wait for each new block, then run nodes until the block is finished. A waiting worker
+        spins briefly, so blocks that follow each other closely start at once, and then parks
+        until the audio thread starts a block or the graph stops. The audio thread runs nodes
+        as well, so a worker that wakes late only costs parallelism, never the block.
+    */
+    void runWorker(int queue)
+    {
+        if (workerThreadSetup) {
+            workerThreadSetup(queue);
+        }
+        unsigned long lastBlock = 0;
+        int idleCount = 0;
+        while (isRunning.load(std::memory_order_relaxed)) {
+            unsigned long currentBlock = block.load(std::memory_order_acquire);
+            if (currentBlock == lastBlock) {
+                if (++idleCount > spinCount) {
+                    park(lastBlock);
+                    idleCount = 0;
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            lastBlock = currentBlock;
+            idleCount = 0;
+            activeWorkers.fetch_add(1);
+            while (unfinishedNodes.load() > 0) {
+                if (!runAvailableNode(queue)) {
+                    std::this_thread::yield();
+                }
+            }
+            activeWorkers.fetch_sub(1);
+        }
+    }
+    
+    /** Sleep until a block after lastBlock starts or the graph stops. The parked count is raised
+        before the block is checked, and the audio thread raises the block before it checks the
+        count, so one of the two always sees the other.
+    */
+    void park(unsigned long lastBlock)
+    {
+        std::unique_lock<std::mutex> lock(parkMutex);
+        parkedWorkers.fetch_add(1, std::memory_order_seq_cst);
+        parkCondition.wait(lock, [this, lastBlock] {
+            return block.load(std::memory_order_seq_cst) != lastBlock || !isRunning.load(std::memory_order_seq_cst);
+        });
+        parkedWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    /** Wake the parked workers. Taking the mutex, even briefly, means any worker that checked
+        the block before it moved on has started waiting, so it cannot miss the notification.
+        The audio thread only tries the lock, so it never blocks. If a worker holds the lock the
+        notification can arrive just before that worker waits, and it then sleeps until the next
+        block, which only costs parallelism as the audio thread runs the nodes as well.
+    */
+    void wakeWorkers()
+    {
+        if (parkMutex.try_lock()) {
+            parkMutex.unlock();
+        }
+        parkCondition.notify_all();
+    }
+    
+    /** Tell the CPU that the thread is spinning, without giving up its time slice.
+    */
+    static void pause()
+    {
+       #if defined (DSPTOOLS_HAS_X86_SIMD)
+        _mm_pause();
+       #endif
+    }
+    
+    /** Wait for any worker that is still leaving the last block, so the nodes and queues can
+        change safely.
+    */
+    void waitForWorkers()
+    {
+        while (activeWorkers.load() > 0) {
+            std::this_thread::yield();
+        }
+    }
+    
+    void stopWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex);
+            isRunning.store(false);
+        }
+        parkCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+    
+    static constexpr int spinCount = 200;
+    
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::vector<Connection> outputConnections;
+    std::vector<int> rootNodes;
+    std::unique_ptr<WorkStealingQueue[]> queues;
+    std::vector<std::thread> workers;
+    std::function<void(int)> workerThreadSetup;
+    std::mutex parkMutex;
+    std::condition_variable parkCondition;
+    std::atomic<int> parkedWorkers {0};
+    int numWorkers = std::max(1, static_cast<int> (std::thread::hardware_concurrency())) - 1;
+    std::atomic<bool> isRunning {false};
+    std::atomic<unsigned long> block {0};
+    std::atomic<int> unfinishedNodes {0};
+    std::atomic<int> activeWorkers {0};
+    AudioBufferInfo<type>* graphInput = nullptr;
+    int numSamples = 0;
+    int maxBufferSize = 0;
+    int numChannels = 0;
+    bool isPrepared = false;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_PROCESSING_GRAPH_HEADER_INCLUDED
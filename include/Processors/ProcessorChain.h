@@ -0,0 +1,190 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_PROCESSOR_CHAIN_HEADER_INCLUDED
+#define DSPTOOLS_PROCESSOR_CHAIN_HEADER_INCLUDED
+
+#include <tuple>
+#include <type_traits>
+#include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+
+namespace DSPTools {
+
+/** Runs a fixed list of audio effects in order, e.g. ProcessorChain<float, Gain<float>, Panner<float>>.
+    Effects that only multiply the audio by a gain, which they show by having a getGainBlock
+    method, are fused with their neighbours: the gains of a run of such effects are multiplied
+    together and applied in a single pass over each channel. Every other effect processes the
+    whole buffer with its processAudio in turn.
+*/
+template <typename type, typename... Effects>
+class ProcessorChain : AudioEffect<type>
+{
+public:
+    ProcessorChain() {}
+    ~ProcessorChain() {}
+    
+    /** Setup the chain and every effect in it. This must be called before calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        std::apply([&] (auto&... effect) { (effect.setup(sampleRate, maxBufferSize, numChannels), ...); }, effects);
+        gainBuffers.setup(2, maxBufferSize);
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Process a buffer of audio with every effect in the chain.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(audioBuffer.getNumSamples() <= gainBuffers.getNumSamples());
+        int stage = 0;
+        while (stage < numStages) {
+            if (!isGainStage[stage]) {
+                forStage(stage, [&] (auto& effect) { processStage(effect, audioBuffer); });
+                ++stage;
+                continue;
+            }
+            int end = stage;
+            while (end < numStages && isGainStage[end]) {
+                ++end;
+            }
+            applyGainStages(audioBuffer, stage, end);
+            stage = end;
+        }
+    }
+    
+    /** Get the total delay the effects add to the audio in samples.
+    */
+    int getLatencyInSamples()
+    {
+        int latency = 0;
+        std::apply([&] (auto&... effect) { ((latency += getStageLatency(effect)), ...); }, effects);
+        return latency;
+    }
+    
+    /** Get one of the effects in the chain to set its parameters.
+    */
+    template <int index>
+    auto& getEffect()
+    {
+        return std::get<index>(effects);
+    }
+    
+private:
+    template <typename Effect, typename = void>
+    struct hasGainBlock : std::false_type {};
+    
+    template <typename Effect>
+    struct hasGainBlock<Effect, std::void_t<decltype(std::declval<Effect&>().getGainBlock(0, static_cast<type*> (nullptr), 0))>> : std::true_type {};
+    
+    template <typename Effect, typename = void>
+    struct hasLatency : std::false_type {};
+    
+    template <typename Effect>
+    struct hasLatency<Effect, std::void_t<decltype(std::declval<Effect&>().getLatencyInSamples())>> : std::true_type {};
+    
+    static constexpr int numStages = sizeof... (Effects);
+    static constexpr bool isGainStage[numStages + 1] = { hasGainBlock<Effects>::value..., false };
+    
+    /** Call function with the effect at a position in the chain.
+    */
+    template <typename Function>
+    void forStage(int index, Function function)
+    {
+        std::apply([&] (auto&... effect) {
+            int position = 0;
+            ((position++ == index ? function(effect) : void()), ...);
+        }, effects);
+    }
+    
+    template <typename Effect>
+    static void processStage(Effect& effect, AudioBufferInfo<type>& audioBuffer)
+    {
+        if constexpr (!hasGainBlock<Effect>::value) {
+            effect.processAudio(audioBuffer);
+        }
+    }
+    
+    template <typename Effect>
+    static int getStageLatency(Effect& effect)
+    {
+        if constexpr (hasLatency<Effect>::value) {
+            return effect.getLatencyInSamples();
+        } else {
+            return 0;
+        }
+    }
+    
+    /** Multiply each channel by the product of the gains of the stages from first to end in one pass.
+    */
+    void applyGainStages(AudioBufferInfo<type>& audioBuffer, int first, int end)
+    {
+        int numSamples = audioBuffer.getNumSamples();
+        auto gains = gainBuffers.getChannelData(0);
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        auto stageGains = gainBuffers.getChannelData(1);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            bool isConstant = true;
+            for (int stage = first; stage < end; ++stage) {
+                forStage(stage, [&] (auto& effect) {
+                    using Effect = std::remove_reference_t<decltype(effect)>;
+                    if constexpr (hasGainBlock<Effect>::value) {
+                        if (stage == first) {
+                            isConstant = effect.getGainBlock(channel, gains, numSamples);
+                            return;
+                        }
+                        bool isStageConstant = effect.getGainBlock(channel, stageGains, numSamples);
+                        if (isConstant && isStageConstant) {
+                            gains[0] *= stageGains[0];
+                            return;
+                        }
+                        if (isConstant) {
+                            std::fill(gains + 1, gains + numSamples, gains[0]);
+                            isConstant = false;
+                        }
+                        if (isStageConstant) {
+                            kernels->multiplyByValue(gains, stageGains[0], numSamples);
+                        } else {
+                            kernels->multiply(gains, stageGains, numSamples);
+                        }
+                    }
+                });
+            }
+            auto data = audioBuffer.getChannelData(channel);
+            if (isConstant) {
+                kernels->multiplyByValue(data, gains[0], numSamples);
+            } else {
+                kernels->multiply(data, gains, numSamples);
+            }
+        }
+    }
+    
+    std::tuple<Effects...> effects;
+    AlignedAudioBuffer<type> gainBuffers;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_PROCESSOR_CHAIN_HEADER_INCLUDED
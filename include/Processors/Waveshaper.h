@@ -0,0 +1,257 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_WAVESHAPER_HEADER_INCLUDED
+#define DSPTOOLS_WAVESHAPER_HEADER_INCLUDED
+
+#include <vector>
+#include "AudioEffect.h"
+#include "../Utilities/AlignedAudioBuffer.h"
+#include "../Utilities/VectorOperations.h"
+#include "../Utilities/Waveshapers.h"
+
+namespace DSPTools {
+
+/** A saturation effect built on the curves in Waveshapers, with modulatable drive and dry/wet mix.
+    Each curve is sampled once into a table shared by every instance, along with its integral,
+    and the audio is shaped by linear interpolation of the table in SIMD blocks, so no curve
+    costs more than another.
+    With antialiasing on, the first order antiderivative method is used: each output sample is
+    the mean of the curve between the current and previous driven inputs, found from the
+    difference of the integral. This strongly reduces aliasing without oversampling, at the
+    cost of a gentle high frequency roll off and a delay of half a sample.
+*/
+template <typename type>
+class Waveshaper : AudioEffect<type>
+{
+public:
+    /** The transfer curves, from the functions of the same names in Waveshapers.
+    */
+    enum Curve {
+        tanH = 0,
+        arraya = 1,
+        sigmoid = 2,
+        sigmoid2 = 3
+    };
+    
+    Waveshaper() {}
+    ~Waveshaper() {}
+    
+    /** Setup the waveshaper. This must be called before calling processAudio.
+    */
+    void setup(double sampleRate, int maxBufferSize, int numChannels)
+    {
+        // The parameters are the same for every channel, so they are evaluated once per block.
+        drive.setup(sampleRate, 1, 0.0, 0.05);
+        mix.setup(sampleRate, 1, 1.0, 0.05);
+        drive.setParameterRange(-24.0, 48.0);
+        mix.setParameterRange(0.0, 1.0);
+        parameterBuffers.setup(2, maxBufferSize);
+        // The shaped channel has room for the previous input in front of the block.
+        workBuffers.setup(3, maxBufferSize + 1);
+        previousInputs.assign(numChannels, 0.0);
+        kernels = &VectorOperations<type>::getBest();
+        setCurve(curve);
+    }
+    
+    /** Process a buffer of audio with the waveshaper.
+    */
+    void processAudio(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(audioBuffer.getNumSamples() <= parameterBuffers.getNumSamples());
+        assert(audioBuffer.getNumChannels() <= previousInputs.size());
+        int numSamples = audioBuffer.getNumSamples();
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        auto gains = parameterBuffers.getChannelData(0);
+        auto mixes = parameterBuffers.getChannelData(1);
+        bool isConstantDrive = drive.fillBlock(0, gains, numSamples, false);
+        bool isConstantMix = mix.fillBlock(0, mixes, numSamples, false);
+        kernels->decibelsToAmplitude(gains, isConstantDrive ? 1 : numSamples);
+        
+        for (int channel = 0; channel < numChannels; ++channel) {
+            auto data = audioBuffer.getChannelData(channel);
+            auto wet = workBuffers.getChannelData(0) + 1;
+            std::copy(data, data + numSamples, wet);
+            if (isConstantDrive) {
+                kernels->multiplyByValue(wet, gains[0], numSamples);
+            } else {
+                kernels->multiply(wet, gains, numSamples);
+            }
+            if (isAntialiased) {
+                shapeAntialiased(channel, wet, numSamples);
+            } else {
+                kernels->interpolateTable(wet, table->values.data(), numPoints, -tableRange, tableStep, numSamples);
+            }
+            
+            if (isConstantMix && mixes[0] == 1.0) {
+                std::copy(wet, wet + numSamples, data);
+            } else if (isConstantMix) {
+                kernels->multiplyByValue(data, type (1.0) - mixes[0], numSamples);
+                kernels->addScaled(data, wet, mixes[0], numSamples);
+            } else {
+                kernels->addScaled(wet, data, -1.0, numSamples);
+                kernels->multiply(wet, mixes, numSamples);
+                kernels->addScaled(data, wet, 1.0, numSamples);
+            }
+        }
+    }
+    
+    /** Set the transfer curve.
+    */
+    void setCurve(Curve newCurve)
+    {
+        curve = newCurve;
+        table = &getTables()[curve];
+    }
+    
+    /** Turn the first order antiderivative antialiasing on or off.
+    */
+    void setAntialiasing(bool shouldAntialias)
+    {
+        isAntialiased = shouldAntialias;
+    }
+    
+    /** Set the drive applied before the curve in dB.
+    */
+    void setDrive(type driveInDb, type modAmount = 0.0)
+    {
+        drive.setParameterValue(driveInDb, modAmount);
+    }
+    
+    /** Set the range of the drive parameter in dB.
+    */
+    void setDriveRange(type minDriveInDb, type maxDriveInDb)
+    {
+        drive.setParameterRange(minDriveInDb, maxDriveInDb);
+    }
+    
+    /** Set the mix from 0, the dry signal only, to 1, the shaped signal only.
+    */
+    void setMix(type mix0To1, type modAmount = 0.0)
+    {
+        mix.setParameterValue(mix0To1, modAmount);
+    }
+    
+    /** Set the modulation source for the drive parameter.
+    */
+    void setDriveModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
+    {
+        drive.setModulationSource(modulationSource);
+    }
+    
+    /** Set the modulation source for the mix parameter.
+    */
+    void setMixModulationSource(std::shared_ptr<ModulationSource<type>> modulationSource)
+    {
+        mix.setModulationSource(modulationSource);
+    }
+    
+    /** Clear the previous input of the antialiasing.
+    */
+    void reset()
+    {
+        std::fill(previousInputs.begin(), previousInputs.end(), type (0.0));
+    }
+    
+private:
+    struct Table
+    {
+        std::vector<type> values;
+        std::vector<type> integrals;
+    };
+    
+    static constexpr int numPoints = 4097;
+    static constexpr type tableRange = 16.0;
+    static constexpr type tableStep = 2.0 * tableRange / (numPoints - 1);
+    
+    /** Shape the driven input in place, where input[-1] is free for the previous input.
+        The difference of the integral is used where the input moves, and the curve at the
+        midpoint where it barely moves and the difference would lose its precision.
+    */
+    void shapeAntialiased(int channel, type* input, int numSamples)
+    {
+        auto integrals = workBuffers.getChannelData(1);
+        auto midpoints = workBuffers.getChannelData(2);
+        input[-1] = previousInputs[channel];
+        previousInputs[channel] = input[numSamples - 1];
+        std::copy(input - 1, input + numSamples, integrals);
+        kernels->integrateTable(integrals, table->values.data(), table->integrals.data(), numPoints, -tableRange, tableStep, numSamples + 1);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            midpoints[sample] = type (0.5) * (input[sample - 1] + input[sample]);
+        }
+        kernels->interpolateTable(midpoints, table->values.data(), numPoints, -tableRange, tableStep, numSamples);
+        const type tolerance = sizeof (type) == sizeof (float) ? 1.0e-2 : 1.0e-5;
+        // Going backwards keeps the previous input of each sample unshaped until it is used.
+        for (int sample = numSamples - 1; sample >= 0; --sample) {
+            auto difference = input[sample] - input[sample - 1];
+            auto mean = (integrals[sample + 1] - integrals[sample]) / difference;
+            input[sample] = std::abs(difference) < tolerance ? midpoints[sample] : mean;
+        }
+    }
+    
+    static const std::vector<Table>& getTables()
+    {
+        static const std::vector<Table> tables = createTables();
+        return tables;
+    }
+    
+    static std::vector<Table> createTables()
+    {
+        type (*curves[])(type) = { Waveshapers<type>::tanHEstimate, Waveshapers<type>::arraya, Waveshapers<type>::sigmoid, Waveshapers<type>::sigmoid2 };
+        std::vector<Table> tables;
+        for (auto function : curves) {
+            Table table;
+            table.values.resize(numPoints);
+            table.integrals.resize(numPoints);
+            for (int point = 0; point < numPoints; ++point) {
+                table.values[point] = function(-tableRange + point * tableStep);
+            }
+            // The integral is measured from the centre of the table, and is exact for the
+            // linear interpolation of the values, so the two methods agree.
+            double integral = 0.0;
+            table.integrals[numPoints / 2] = 0.0;
+            for (int point = numPoints / 2 + 1; point < numPoints; ++point) {
+                integral += 0.5 * tableStep * (static_cast<double> (table.values[point - 1]) + table.values[point]);
+                table.integrals[point] = static_cast<type> (integral);
+            }
+            integral = 0.0;
+            for (int point = numPoints / 2 - 1; point >= 0; --point) {
+                integral -= 0.5 * tableStep * (static_cast<double> (table.values[point + 1]) + table.values[point]);
+                table.integrals[point] = static_cast<type> (integral);
+            }
+            tables.push_back(std::move(table));
+        }
+        return tables;
+    }
+    
+    ModulationParameter<type> drive, mix;
+    AlignedAudioBuffer<type> parameterBuffers, workBuffers;
+    std::vector<type> previousInputs;
+    const Table* table = nullptr;
+    Curve curve = tanH;
+    bool isAntialiased = false;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_WAVESHAPER_HEADER_INCLUDED
@@ -0,0 +1,153 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_ALIGNED_AUDIO_BUFFER_HEADER_INCLUDED
+#define DSPTOOLS_ALIGNED_AUDIO_BUFFER_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <vector>
+#include "AudioBufferInfo.h"
+
+namespace DSPTools {
+
+/** An owning multi-channel audio buffer for internal scratch space, allocated once in setup().
+    All channels share one contiguous block. Every channel starts on a 64 byte boundary, the
+    width of the largest SIMD register, and is padded to a whole number of 64 byte lines, so a
+    kernel may run whole registers past the last sample, up to getPaddedLength(numSamples),
+    without touching the next channel.
+*/
+template <typename type>
+class AlignedAudioBuffer
+{
+public:
+    static constexpr int alignment = 64;
+    
+    AlignedAudioBuffer() {}
+    ~AlignedAudioBuffer() {}
+    
+    AlignedAudioBuffer(const AlignedAudioBuffer& other)
+    {
+        *this = other;
+    }
+    
+    AlignedAudioBuffer& operator=(const AlignedAudioBuffer& other)
+    {
+        if (this != &other) {
+            setup(other.numChannels, other.numSamples);
+            std::copy(other.storage.get(), other.storage.get() + numChannels * channelStride, storage.get());
+        }
+        return *this;
+    }
+    
+    /** Allocate the buffer and clear it to zero. This allocates, so call it from setup().
+    */
+    void setup(int numChannels, int numSamples)
+    {
+        assert(numChannels >= 0 && numSamples >= 0);
+        this->numChannels = numChannels;
+        this->numSamples = numSamples;
+        channelStride = getPaddedLength(numSamples);
+        storage.reset(numChannels * channelStride > 0 ? static_cast<type*> (::operator new[](numChannels * channelStride * sizeof(type), std::align_val_t(alignment))) : nullptr);
+        channels.resize(numChannels);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            channels[channel] = storage.get() + channel * channelStride;
+        }
+        clear();
+    }
+    
+    /** Set every sample, including the padding, to zero.
+    */
+    void clear()
+    {
+        std::fill(storage.get(), storage.get() + numChannels * channelStride, type (0));
+    }
+    
+    /** Returns a pointer to the samples of the chosen channel, aligned to 64 bytes.
+    */
+    type* getChannelData(int channel) const
+    {
+        assert(channel >= 0 && channel < numChannels);
+        return channels[channel];
+    }
+    
+    /** Returns the array of channel pointers.
+    */
+    type* const* getArrayOfChannels() const
+    {
+        return channels.data();
+    }
+    
+    /** Returns the number of channels.
+    */
+    int getNumChannels() const
+    {
+        return numChannels;
+    }
+    
+    /** Returns the number of samples each channel was set up to hold.
+    */
+    int getNumSamples() const
+    {
+        return numSamples;
+    }
+    
+    /** Returns a view of the first numSamplesInView samples of every channel.
+    */
+    AudioBufferInfo<type> getBufferInfo(int numSamplesInView) const
+    {
+        assert(numSamplesInView <= numSamples);
+        return AudioBufferInfo<type>(channels.data(), numChannels, numSamplesInView);
+    }
+    
+    /** Returns numSamples rounded up to a whole number of 64 byte lines, which is always
+        within the padded storage of a channel holding at least numSamples.
+    */
+    static constexpr int getPaddedLength(int numSamples)
+    {
+        return (numSamples + samplesPerLine - 1) / samplesPerLine * samplesPerLine;
+    }
+    
+private:
+    struct AlignedDelete
+    {
+        void operator()(type* data) const
+        {
+            ::operator delete[](data, std::align_val_t(alignment));
+        }
+    };
+    
+    static constexpr int samplesPerLine = alignment / sizeof(type) > 0 ? int (alignment / sizeof(type)) : 1;
+    
+    std::unique_ptr<type[], AlignedDelete> storage;
+    std::vector<type*> channels;
+    int numChannels = 0;
+    int numSamples = 0;
+    int channelStride = 0;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_ALIGNED_AUDIO_BUFFER_HEADER_INCLUDED
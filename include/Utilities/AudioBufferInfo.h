@@ -23,54 +23,116 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_AUDIO_BUFFER_INFO_HEADER_INCLUDED
 #define DSPTOOLS_AUDIO_BUFFER_INFO_HEADER_INCLUDED
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 
 namespace DSPTools {
 
-template <typename type>
+/** A view of the channels of an audio buffer, holding up to maxChannels channel pointers in
+    fixed inline storage so that building one never allocates. The view does not own the
+    audio, and subBlock and channelSubset return further views of the same memory.
+*/
+template <typename type, int maxChannels = 32>
 class AudioBufferInfo
 {
 public:
     AudioBufferInfo () {}
     ~AudioBufferInfo () {}
     
-    /** Adds a channel of audio samples to the buffer info object.
+    /** Creates a view of an array of channel pointers, such as the write pointers of a host buffer.
+        Only the first maxChannels channels are viewed; compare getNumChannels with the number
+        given to find out whether any were left out.
     */
-    void appendChannel(int numSamples, type* newData, int channelIndex)
+    AudioBufferInfo (type* const* channelData, int numChannels, int numSamples)
+    {
+        assert(numChannels >= 0 && numChannels <= maxChannels);
+        numChannels = std::max(0, std::min(numChannels, maxChannels));
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            data[channel] = channelData[channel];
+        }
+        this->numChannels = numChannels;
+        this->numSamples = numSamples;
+    }
+    
+    /** Adds a channel of audio samples to the buffer info object. Adding channel 0 removes
+        any channels added before it. Returns false, leaving the channel out, if the object
+        already holds maxChannels channels.
+    */
+    bool appendChannel(int numSamples, type* newData, int channelIndex)
     {
         assert(numSamples > 0);
         assert(channelIndex >= 0);
         if (channelIndex == 0)
         {
-            data.clear();
+            numChannels = 0;
+        }
+        assert(numChannels < maxChannels);
+        if (numChannels >= maxChannels)
+        {
+            return false;
         }
-        data.push_back(newData);
+        data[numChannels++] = newData;
         this->numSamples = numSamples;
+        return true;
+    }
+    
+    /** Returns a view of the samples from offset to offset + length in every channel.
+    */
+    AudioBufferInfo subBlock(int offset, int length) const
+    {
+        assert(offset >= 0 && length >= 0 && offset + length <= numSamples);
+        AudioBufferInfo block;
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            block.data[channel] = data[channel] + offset;
+        }
+        block.numChannels = numChannels;
+        block.numSamples = length;
+        return block;
+    }
+    
+    /** Returns a view of the channels from firstChannel to firstChannel + numChannelsInSubset.
+    */
+    AudioBufferInfo channelSubset(int firstChannel, int numChannelsInSubset) const
+    {
+        assert(firstChannel >= 0 && numChannelsInSubset >= 0 && firstChannel + numChannelsInSubset <= numChannels);
+        return AudioBufferInfo(data.data() + firstChannel, numChannelsInSubset, numSamples);
     }
     
     /** Returns the number of samples in the buffer info object.
     */
-    int getNumSamples()
+    int getNumSamples() const
     {
         return numSamples;
     }
     
     /** Returns the number of channels in the buffer info object.
     */
-    unsigned long getNumChannels()
+    unsigned long getNumChannels() const
     {
-        return data.size();
+        return numChannels;
     }
     
     /** Returns a pointer to the audio data of the chosen channel.
     */
-    type* getChannelData(int channel)
+    type* getChannelData(int channel) const
     {
+        assert(channel >= 0 && channel < numChannels);
         return data[channel];
     }
     
+    /** Returns the array of channel pointers.
+    */
+    type* const* getArrayOfChannels() const
+    {
+        return data.data();
+    }
+    
 private:
-    std::vector<type*> data;
+    std::array<type*, maxChannels> data {};
+    int numChannels = 0;
     int numSamples = 0;
 };
 
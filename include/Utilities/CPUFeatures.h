@@ -0,0 +1,81 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_CPU_FEATURES_HEADER_INCLUDED
+#define DSPTOOLS_CPU_FEATURES_HEADER_INCLUDED
+
+#include "SIMDRegister.h"
+
+#if defined (DSPTOOLS_HAS_X86_SIMD) && defined (_MSC_VER) && ! defined (__clang__)
+ #include <intrin.h>
+#endif
+
+namespace DSPTools {
+
+/** The instruction sets supported by the CPU that the program is running on.
+    The CPU is only queried the first time get() is called.
+*/
+class CPUFeatures
+{
+public:
+    /** Get the features of the running CPU.
+    */
+    static const CPUFeatures& get()
+    {
+        static const CPUFeatures features;
+        return features;
+    }
+    
+    bool hasSSE2 = false, hasAVX2 = false, hasAVX512 = false;
+    
+private:
+    CPUFeatures()
+    {
+       #if defined (DSPTOOLS_HAS_X86_SIMD)
+        #if defined (_MSC_VER) && ! defined (__clang__)
+        int registers[4];
+        __cpuid(registers, 0);
+        int maxLeaf = registers[0];
+        __cpuid(registers, 1);
+        bool hasOSXSave = (registers[2] & (1 << 27)) != 0;
+        hasSSE2 = (registers[3] & (1 << 26)) != 0;
+        if (hasOSXSave && maxLeaf >= 7) {
+            auto enabledStates = _xgetbv(0);
+            bool osSavesAVX = (enabledStates & 0x6) == 0x6;
+            bool osSavesAVX512 = (enabledStates & 0xe6) == 0xe6;
+            __cpuidex(registers, 7, 0);
+            hasAVX2 = osSavesAVX && (registers[1] & (1 << 5)) != 0;
+            hasAVX512 = osSavesAVX512 && (registers[1] & (1 << 16)) != 0;
+        }
+        #else
+        __builtin_cpu_init();
+        hasSSE2 = __builtin_cpu_supports("sse2");
+        hasAVX2 = __builtin_cpu_supports("avx2");
+        hasAVX512 = __builtin_cpu_supports("avx512f");
+        #endif
+       #endif
+    }
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_CPU_FEATURES_HEADER_INCLUDED
@@ -24,16 +24,24 @@ SOFTWARE.*/
 #define DSPTOOLS_ENVELOPE_FOLLOWER_HEADER_INCLUDED
 
 #include "Maths.h"
+#include "VectorOperations.h"
 
 namespace DSPTools {
 
+/** Follows the level of one or more channels.
+    The peak mode smooths the signal with separate attack and release times. The rms mode
+    does the same to the squared signal, and the windowedRms mode takes the true RMS over the
+    last getWindowLength seconds, ignoring the attack and release. Both rms modes keep their
+    state as a mean square, so the square root is only taken when an envelope is read.
+*/
 template <typename type>
 class EnvelopeFollower
 {
     public:
     enum Mode {
         peak = 0,
-        rms = 1
+        rms = 1,
+        windowedRms = 2
     };
     
     EnvelopeFollower() {}
@@ -53,6 +61,11 @@ class EnvelopeFollower
         for (int channel = 0; channel < numChannels; ++channel) {
             lastOut[channel] = 0.0;
         }
+        windows.resize(numChannels);
+        windowPositions.resize(numChannels);
+        windowSums.resize(numChannels);
+        setWindowLength(windowLength);
+        kernels = &VectorOperations<type>::getBest();
     }
     
     /** Get the attack value of the envelope in seconds.
@@ -73,6 +86,9 @@ class EnvelopeFollower
     */
     void setAttack(type value)
     {
+        if (value == attack) {
+            return;
+        }
         attack = value;
         calculateAttackCoefficient(value);
     }
@@ -81,37 +97,125 @@ class EnvelopeFollower
     */
     void setRelease(type value)
     {
+        if (value == release) {
+            return;
+        }
         release = value;
         calculateReleaseCoefficient(value);
     }
     
+    /** Get the length of the windowedRms window in seconds.
+    */
+    type getWindowLength()
+    {
+        return windowLength;
+    }
+    
+    /** Set the length of the windowedRms window in seconds and clear the windows.
+        This allocates memory so it should be called alongside setup, not while processing.
+    */
+    void setWindowLength(type time)
+    {
+        assert(time > 0.0);
+        windowLength = time;
+        auto length = std::max(1, static_cast<int> (std::round(time * sampleRate)));
+        for (int channel = 0; channel < static_cast<int> (windows.size()); ++channel) {
+            windows[channel].assign(length, type (0.0));
+            windowPositions[channel] = 0;
+            windowSums[channel] = 0.0;
+            if (mode == windowedRms) {
+                lastOut[channel] = 0.0;
+            }
+        }
+    }
+    
     /** Set the envelope detection mode.
     */
     void setMode(Mode newMode)
     {
+        bool wasSquared = (mode != peak);
         mode = newMode;
+        if (mode == windowedRms) {
+            setWindowLength(windowLength);
+        } else if (wasSquared != (mode != peak)) {
+            for (auto& state : lastOut) {
+                state = wasSquared ? std::sqrt(state) : state * state;
+            }
+        }
     }
     
     /** Calculate the envelope of a sample.
     */
     type calculateEnvelope(type value, int channel)
     {
-        lastOut[channel] = (value > lastOut[channel]) ? calculateEnvelopeInAttack(value, channel) : calculateEnvelopeInRelease(value, channel);
-        return lastOut[channel];
+        update(value, channel);
+        return getEnvelope(channel);
     }
     
-private:
+    /** Add a sample to the envelope of a channel without reading the envelope.
+    */
+    void update(type value, int channel)
+    {
+        auto& state = lastOut[channel];
+        if (mode == peak) {
+            state = value + ((value > state) ? attackCoefficient : releaseCoefficient) * (state - value);
+        } else if (mode == rms) {
+            // value > sqrt(state), without the square root.
+            auto coefficient = (value > 0.0 && value * value > state) ? attackCoefficient : releaseCoefficient;
+            state = value * value + coefficient * (state - value * value);
+        } else {
+            updateWindow(value, channel);
+        }
+    }
     
-    type calculateEnvelopeInAttack(type value, int channel)
+    /** Get the current envelope of a channel.
+    */
+    type getEnvelope(int channel)
+    {
+        return (mode == peak) ? lastOut[channel] : std::sqrt(lastOut[channel]);
+    }
+    
+    /** Calculate the envelopes of a block of samples for the first numChannels channels.
+        In the peak and rms modes the channels are processed side by side in SIMD registers
+        using the current attack and release.
+    */
+    void calculateEnvelopeBlock(const type* const* input, type* const* output, int numChannels, int numSamples)
     {
-        return (mode == rms) ?  sqrt(attackCoefficient * pow(lastOut[channel], 2.0) + (1.0 - attackCoefficient) * pow(value, 2.0))
-                                : value + attackCoefficient * (lastOut[channel] - value);
+        assert(numChannels <= static_cast<int> (lastOut.size()));
+        if (mode != windowedRms) {
+            kernels->followEnvelopes(input, output, lastOut.data(), numChannels, numSamples, attackCoefficient, releaseCoefficient, mode == rms);
+            return;
+        }
+        for (int channel = 0; channel < numChannels; ++channel) {
+            for (int sample = 0; sample < numSamples; ++sample) {
+                updateWindow(input[channel][sample], channel);
+                output[channel][sample] = std::sqrt(lastOut[channel]);
+            }
+        }
     }
     
-    type calculateEnvelopeInRelease(type value, int channel)
+private:
+    
+    /** Replace the oldest square in the window with a new one and update the mean square.
+        The running sum is recalculated once per window so rounding errors cannot build up.
+    */
+    void updateWindow(type value, int channel)
     {
-        return (mode == rms) ? sqrt(releaseCoefficient * pow(lastOut[channel], 2.0) + (1.0 - releaseCoefficient) * pow(value, 2.0))
-                                : value + releaseCoefficient * (lastOut[channel] - value);
+        auto& window = windows[channel];
+        auto& position = windowPositions[channel];
+        auto length = static_cast<int> (window.size());
+        auto& sum = windowSums[channel];
+        type square = value * value;
+        sum += square - window[position];
+        window[position] = square;
+        if (++position == length) {
+            position = 0;
+            sum = 0.0;
+            for (auto windowSquare : window) {
+                sum += windowSquare;
+            }
+        }
+        lastOut[channel] = std::max(type (0.0), sum / length);
     }
     
     void calculateAttackCoefficient(type time)
@@ -124,10 +228,14 @@ private:
         releaseCoefficient = pow(Maths<type>::euler, -1.0 / (time * sampleRate));
     }
     
-    type attackCoefficient = 0.0, releaseCoefficient = 0.0, attack = 0.01, release = 0.05;
+    type attackCoefficient = 0.0, releaseCoefficient = 0.0, attack = 0.01, release = 0.05, windowLength = 0.05;
     std::vector<type> lastOut;
+    std::vector<std::vector<type>> windows;
+    std::vector<type> windowSums;
+    std::vector<int> windowPositions;
     double sampleRate = 1.0;
     Mode mode = peak;
+    const VectorOperations<type>* kernels = nullptr;
 };
 
 } // namespace DSPTools
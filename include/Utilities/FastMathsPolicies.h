@@ -0,0 +1,93 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_FAST_MATHS_POLICIES_HEADER_INCLUDED
+#define DSPTOOLS_FAST_MATHS_POLICIES_HEADER_INCLUDED
+
+namespace DSPTools {
+
+/** Accuracy policy that uses the standard library functions.
+*/
+struct ExactAccuracy {};
+
+/** Accuracy policy for approximations that are good to about 1e-5 or better.
+    Maximum errors in double and in float precision, over exp2 inputs of -60 to 60, log2 and
+    amplitudeToDecibels inputs of 1e-30 to 1e4, sine phases of 0 to 1 and dB values of -200
+    to 40:
+    - exp2: 8.3e-8 relative, 2.0e-7 in float
+    - log2: 2.1e-6 absolute, 6.5e-6 in float
+    - sine: 6.0e-7 absolute, 7.5e-7 in float
+    - decibelsToAmplitude: 8.3e-8 relative, 1.6e-6 in float
+    - amplitudeToDecibels: 1.3e-5 dB absolute, 7.5e-5 dB in float
+    The float results are also rounded to float, which adds about one float epsilon (1.2e-7)
+    relative. For large logarithms this dominates, as it does for 20 * std::log10 in float.
+    decibelsToAmplitude loses more because the exponent it calculates from the dB value is
+    itself only float accurate, so its float error grows with the size of the dB value.
+    examples/Tests/FastMathsAccuracyTest.cpp checks these bounds.
+*/
+struct HighAccuracy
+{
+    static constexpr int exp2Order = 5;
+    static constexpr double exp2Coefficients[exp2Order] = {
+        0.69315131179805567, 0.24016445022542493, 0.055799912878300877, 0.0090170306017895718, 0.0018671299518420383
+    };
+    
+    static constexpr int log2Order = 6;
+    static constexpr double log2Coefficients[log2Order] = {
+        1.4425531444704005, -0.71828191135162944, 0.45827077145093936, -0.27953806917092844, 0.12345142385859438, -0.026457427986222117
+    };
+    
+    static constexpr int sineOrder = 4;
+    static constexpr double sineCoefficients[sineOrder] = {
+        6.2831640443529686, -41.337142376356603, 81.340769038470597, -70.993434559701001
+    };
+};
+
+/** Accuracy policy for approximations that are good to about 1e-3 or better.
+    Maximum errors in double and in float precision, over the same inputs as HighAccuracy:
+    - exp2: 8.6e-5 relative, 8.7e-5 in float
+    - log2: 7.8e-4 absolute, 7.8e-4 in float
+    - sine: 6.8e-5 absolute, 6.9e-5 in float
+    - decibelsToAmplitude: 8.6e-5 relative, 8.8e-5 in float
+    - amplitudeToDecibels: 4.7e-3 dB absolute, 4.8e-3 dB in float
+*/
+struct LowAccuracy
+{
+    static constexpr int exp2Order = 3;
+    static constexpr double exp2Coefficients[exp2Order] = {
+        0.69511678705092883, 0.22764498966297558, 0.077067042885575213
+    };
+    
+    static constexpr int log2Order = 3;
+    static constexpr double log2Coefficients[log2Order] = {
+        1.4245938417937749, -0.58920659826687483, 0.16538370432105801
+    };
+    
+    static constexpr int sineOrder = 3;
+    static constexpr double sineCoefficients[sineOrder] = {
+        6.2812800799153132, -41.095242865573873, 73.585516837906667
+    };
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_FAST_MATHS_POLICIES_HEADER_INCLUDED
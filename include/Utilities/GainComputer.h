@@ -0,0 +1,122 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_GAIN_COMPUTER_HEADER_INCLUDED
+#define DSPTOOLS_GAIN_COMPUTER_HEADER_INCLUDED
+
+#include <vector>
+#include "Maths.h"
+
+namespace DSPTools {
+
+/** The static curve of a compressor, mapping an envelope level to a gain.
+    The curve can be evaluated exactly in dB, or through a table of linear gains that is
+    indexed by a fast log2 of the envelope and linearly interpolated. The table is only
+    rebuilt when the threshold, ratio or knee change.
+*/
+template <typename type>
+class GainComputer
+{
+public:
+    GainComputer() : table(numPoints) {}
+    ~GainComputer() {}
+    
+    /** Calculate the gain in dB for an envelope in dBFS.
+    */
+    static type calculateGain(type ratio, type thresholdInDb, type envelopeInDb, type knee)
+    {
+        auto kneeWidth = thresholdInDb * knee * -1.0;
+        auto lowerKneeBound = thresholdInDb - (kneeWidth / 2.0);
+        auto upperKneeBound = thresholdInDb + (kneeWidth / 2.0);
+        auto slope = 1.0 - (1.0 / ratio);
+        
+        if (knee > 0.0 && envelopeInDb > lowerKneeBound && envelopeInDb < upperKneeBound) {
+            slope *= (((envelopeInDb - lowerKneeBound) / kneeWidth) * 0.5);
+            return slope * (lowerKneeBound - envelopeInDb);
+        } else
+        {
+            slope *= (thresholdInDb - envelopeInDb);
+            return std::min(0.0, slope);
+        }
+    }
+    
+    /** Set the curve used by getGainAmplitude. The table is rebuilt only if a value has changed.
+    */
+    void setParameters(type thresholdInDb, type ratio, type knee)
+    {
+        if (hasTable && thresholdInDb == currentThreshold && ratio == currentRatio && knee == currentKnee) {
+            return;
+        }
+        hasTable = true;
+        currentThreshold = thresholdInDb;
+        currentRatio = ratio;
+        currentKnee = knee;
+        
+        // The table points are placed so that one falls exactly on the threshold, which keeps the
+        // corner of a hard knee exact. Interpolating between them is then accurate to better than 1e-3 dB.
+        firstPointInDb = thresholdInDb - std::ceil((thresholdInDb - minimumDb) / stepInDb) * stepInDb;
+        for (int point = 0; point < numPoints; ++point) {
+            type envelopeInDb = firstPointInDb + point * stepInDb;
+            table[point] = Maths<type>::decibelsToAmplitude(calculateGain(ratio, thresholdInDb, envelopeInDb, knee));
+        }
+    }
+    
+    /** Get the linear gain for a linear envelope value from the table.
+        Envelopes outside the table range use the gain at the nearest end of the table.
+    */
+    type getGainAmplitude(type envelope)
+    {
+        type position = FastMaths<type>::log2(envelope) * type (decibelsPerOctave / stepInDb) - firstPointInDb / stepInDb;
+        position = Maths<type>::limit(0.0, type (numPoints - 2), position);
+        auto index = static_cast<int> (position);
+        auto fraction = position - index;
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+    
+    /** Replace a buffer of linear envelope values with their linear gains from the table.
+        The log2 of the whole block is taken with the SIMD kernels before the table is read.
+    */
+    void getGainAmplitudes(type* data, int numSamples)
+    {
+        FastMaths<type>::log2(data, numSamples);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            type position = data[sample] * type (decibelsPerOctave / stepInDb) - firstPointInDb / stepInDb;
+            position = Maths<type>::limit(0.0, type (numPoints - 2), position);
+            auto index = static_cast<int> (position);
+            auto fraction = position - index;
+            data[sample] = table[index] + fraction * (table[index + 1] - table[index]);
+        }
+    }
+    
+private:
+    static constexpr double decibelsPerOctave = 6.0205999132796239042;
+    static constexpr double minimumDb = -150.0, maximumDb = 50.0, stepInDb = 0.1;
+    static constexpr int numPoints = static_cast<int> ((maximumDb - minimumDb) / stepInDb) + 3;
+    
+    std::vector<type> table;
+    bool hasTable = false;
+    type currentThreshold = 0.0, currentRatio = 0.0, currentKnee = 0.0, firstPointInDb = 0.0;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_GAIN_COMPUTER_HEADER_INCLUDED
@@ -23,6 +23,8 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_MATHS_HEADER_INCLUDED
 #define DSPTOOLS_MATHS_HEADER_INCLUDED
 
+#include "VectorOperations.h"
+
 namespace DSPTools {
 
 template <typename type>
@@ -100,6 +102,92 @@ public:
     }
 };
 
+/** Fast approximations of exp2, log2, sine and the dB conversions above, using bit tricks and
+    minimax polynomials. The Accuracy policy is ExactAccuracy, HighAccuracy (about 1e-5) or
+    LowAccuracy (about 1e-3); see FastMathsPolicies.h for the maximum error of each function.
+    The buffer versions run on the widest SIMD instruction set that the CPU supports.
+*/
+template <typename type, typename Accuracy = HighAccuracy>
+class FastMaths
+{
+public:
+    /** Calculate 2 to the power of x.
+    */
+    static type exp2(type x)
+    {
+        return Kernels::template approximateExp2<Scalar, Accuracy>(x);
+    }
+    
+    /** Calculate the base 2 logarithm of x.
+    */
+    static type log2(type x)
+    {
+        return Kernels::template approximateLog2<Scalar, Accuracy>(x);
+    }
+    
+    /** Calculate a sine wave based on a phase value, where 1 is a full cycle.
+    */
+    static type sine(type phase)
+    {
+        return Kernels::template approximateSine<Scalar, Accuracy>(phase);
+    }
+    
+    /** Converts dBFS to amplitude.
+        Note: 1.0 = 0dBFS.
+    */
+    static type decibelsToAmplitude(type dB)
+    {
+        return Kernels::template approximateDecibelsToAmplitude<Scalar, Accuracy>(dB);
+    }
+    
+    /** Converts amplitude to dBFS.
+        Note: 1.0 = 0dBFS.
+    */
+    static type amplitudeToDecibels(type amplitude)
+    {
+        return Kernels::template approximateAmplitudeToDecibels<Scalar, Accuracy>(amplitude);
+    }
+    
+    /** Calculate 2 to the power of each value in a buffer.
+    */
+    static void exp2(type* data, int numSamples)
+    {
+        VectorOperations<type, Accuracy>::getBest().exp2(data, numSamples);
+    }
+    
+    /** Calculate the base 2 logarithm of each value in a buffer.
+    */
+    static void log2(type* data, int numSamples)
+    {
+        VectorOperations<type, Accuracy>::getBest().log2(data, numSamples);
+    }
+    
+    /** Replace each phase value in a buffer with the value of a sine wave at that phase.
+    */
+    static void sine(type* data, int numSamples)
+    {
+        VectorOperations<type, Accuracy>::getBest().sine(data, numSamples);
+    }
+    
+    /** Convert a buffer of dBFS values to amplitudes.
+    */
+    static void decibelsToAmplitude(type* data, int numSamples)
+    {
+        VectorOperations<type, Accuracy>::getBest().decibelsToAmplitude(data, numSamples);
+    }
+    
+    /** Convert a buffer of amplitudes to dBFS values.
+    */
+    static void amplitudeToDecibels(type* data, int numSamples)
+    {
+        VectorOperations<type, Accuracy>::getBest().amplitudeToDecibels(data, numSamples);
+    }
+    
+private:
+    using Kernels = ScalarKernels::Kernels<type>;
+    using Scalar = SIMDRegister<type, ScalarInstructions>;
+};
+
 } // namespace DSPTools
 
 #endif // DSPTOOLS_MATHS_HEADER_INCLUDED
@@ -0,0 +1,245 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_OVERSAMPLER_HEADER_INCLUDED
+#define DSPTOOLS_OVERSAMPLER_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include "AlignedAudioBuffer.h"
+#include "AudioBufferInfo.h"
+#include "Maths.h"
+#include "VectorOperations.h"
+
+namespace DSPTools {
+
+/** Raises a block of audio to 2, 4, 8 or 16 times its sample rate and brings it back down, so
+    nonlinear processing can run above the base rate without aliasing.
+    Each factor of two is a stage with a linear phase half-band FIR filter. Every other tap of a
+    half-band filter is zero apart from the centre tap, so each stage is split into its two
+    polyphase branches: one is a plain delay and the other is a short FIR at the lower rate,
+    run with the convolve kernel. The first stage has the steepest filter, as the later stages
+    only have to reject images far above the audio band. The delay of the round trip is made a
+    whole number of samples at the base rate, reported by getLatencyInSamples.
+    All buffers are allocated in setup.
+*/
+template <typename type>
+class Oversampler
+{
+public:
+    Oversampler() {}
+    ~Oversampler() {}
+    
+    static constexpr int maxStages = 4;
+    
+    /** Setup the oversampler with a number of 2x stages from 1 to 4, for 2x to 16x oversampling.
+        This must be called before calling upsample.
+    */
+    void setup(int numStages, int maxBufferSize, int numChannels)
+    {
+        assert(numStages >= 1 && numStages <= maxStages);
+        this->numStages = numStages;
+        stages.resize(numStages);
+        int delay = 0;
+        for (int index = 0; index < numStages; ++index) {
+            auto& stage = stages[index];
+            auto maxInputSize = maxBufferSize << index;
+            designFilter(stage, halfLengths[index]);
+            stage.output.setup(numChannels, 2 * maxInputSize);
+            stage.upHistory.setup(numChannels, stage.numTaps - 1 + maxInputSize);
+            stage.filtered.setup(1, maxInputSize);
+            // A stage delays the audio by numTaps - 1 samples at its lower rate, counted here at the top rate.
+            delay += (stage.numTaps - 1) << (numStages - 1 - index);
+        }
+        // Delaying both polyphase branches of the last decimator by a sample each rounds the
+        // total delay up to a whole number of base rate samples.
+        auto factor = getOversamplingFactor();
+        auto topRateDelay = 2 * delay;
+        stages.back().extraDelay = (factor - topRateDelay % factor) % factor / 2;
+        latency = (topRateDelay + 2 * stages.back().extraDelay) / factor;
+        for (int index = 0; index < numStages; ++index) {
+            auto& stage = stages[index];
+            auto maxInputSize = maxBufferSize << index;
+            stage.evenHistory.setup(numChannels, stage.numTaps - 1 + stage.extraDelay + maxInputSize);
+            stage.oddHistory.setup(numChannels, stage.numTaps / 2 + stage.extraDelay + maxInputSize);
+        }
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Clear the filter history of all channels.
+    */
+    void reset()
+    {
+        for (auto& stage : stages) {
+            stage.upHistory.clear();
+            stage.evenHistory.clear();
+            stage.oddHistory.clear();
+        }
+    }
+    
+    /** Upsample a block of audio. The returned buffer holds getOversamplingFactor() times as many
+        samples and stays valid until the next call, so it can be processed in place before
+        calling downsample.
+    */
+    AudioBufferInfo<type> upsample(AudioBufferInfo<type>& audioBuffer)
+    {
+        assert(!stages.empty());
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        auto numSamples = audioBuffer.getNumSamples();
+        assert(numChannels <= stages[0].output.getNumChannels());
+        assert(numSamples <= stages[0].upHistory.getNumSamples() - (stages[0].numTaps - 1));
+        for (int index = 0; index < numStages; ++index) {
+            auto& stage = stages[index];
+            for (int channel = 0; channel < numChannels; ++channel) {
+                auto input = (index == 0) ? audioBuffer.getChannelData(channel) : stages[index - 1].output.getChannelData(channel);
+                interpolate(stage, channel, input, stage.output.getChannelData(channel), numSamples << index);
+            }
+        }
+        return AudioBufferInfo<type>(stages.back().output.getArrayOfChannels(), numChannels, numSamples * getOversamplingFactor());
+    }
+    
+    /** Downsample the buffer returned by the last call to upsample back into a block of audio,
+        which must have the same size as the block given to upsample.
+    */
+    void downsample(AudioBufferInfo<type>& audioBuffer)
+    {
+        int numChannels = static_cast<int> (audioBuffer.getNumChannels());
+        auto numSamples = audioBuffer.getNumSamples();
+        for (int index = numStages - 1; index >= 0; --index) {
+            auto& stage = stages[index];
+            for (int channel = 0; channel < numChannels; ++channel) {
+                auto output = (index == 0) ? audioBuffer.getChannelData(channel) : stages[index - 1].output.getChannelData(channel);
+                decimate(stage, channel, stage.output.getChannelData(channel), output, numSamples << index);
+            }
+        }
+    }
+    
+    /** Get the oversampling factor.
+    */
+    int getOversamplingFactor() const
+    {
+        return 1 << numStages;
+    }
+    
+    /** Get the delay of a round trip through upsample and downsample in samples at the base rate.
+    */
+    int getLatencyInSamples() const
+    {
+        return latency;
+    }
+    
+private:
+    struct Stage
+    {
+        /** The taps of the FIR branch, which are the even taps of the half-band filter. The
+            centre tap of 0.5 is the other branch.
+        */
+        std::vector<type> coefficients;
+        int numTaps = 0;
+        int extraDelay = 0;
+        AlignedAudioBuffer<type> output, upHistory, filtered, evenHistory, oddHistory;
+    };
+    
+    /** Half the number of taps in the FIR branch of each stage, from the first stage. */
+    static constexpr int halfLengths[maxStages] = {16, 6, 5, 4};
+    
+    /** Design a Kaiser windowed sinc half-band filter and keep the taps of its FIR branch.
+    */
+    static void designFilter(Stage& stage, int halfLength)
+    {
+        constexpr double beta = 8.0;
+        auto length = 4 * halfLength - 1, centre = 2 * halfLength - 1;
+        stage.numTaps = 2 * halfLength;
+        stage.coefficients.resize(stage.numTaps);
+        type sum = 0.0;
+        for (int tap = 0; tap < stage.numTaps; ++tap) {
+            auto time = (2 * tap - centre) / 2.0;
+            auto sinc = std::sin(Maths<double>::pi * time) / (Maths<double>::pi * time);
+            auto position = 2.0 * (2 * tap) / (length - 1) - 1.0;
+            auto window = besselI0(beta * std::sqrt(1.0 - position * position)) / besselI0(beta);
+            stage.coefficients[tap] = static_cast<type> (sinc * window);
+            sum += stage.coefficients[tap];
+        }
+        // The FIR branch is normalised to a gain of 1, so a constant signal passes unchanged.
+        for (auto& coefficient : stage.coefficients) {
+            coefficient /= sum;
+        }
+    }
+    
+    static double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+    
+    /** Write 2 * numSamples samples at the higher rate. The even samples are the FIR branch and
+        the odd samples are the input delayed by the centre of the filter.
+    */
+    void interpolate(Stage& stage, int channel, const type* input, type* output, int numSamples)
+    {
+        auto historyLength = stage.numTaps - 1;
+        auto history = stage.upHistory.getChannelData(channel);
+        std::copy(input, input + numSamples, history + historyLength);
+        auto filtered = stage.filtered.getChannelData(0);
+        kernels->convolve(filtered, history, stage.coefficients.data(), stage.numTaps, numSamples);
+        auto delayed = history + stage.numTaps / 2;
+        for (int sample = 0; sample < numSamples; ++sample) {
+            output[2 * sample] = filtered[sample];
+            output[2 * sample + 1] = delayed[sample];
+        }
+        std::copy(history + numSamples, history + numSamples + historyLength, history);
+    }
+    
+    /** Write numSamples samples at the lower rate from 2 * numSamples samples at the higher rate.
+    */
+    void decimate(Stage& stage, int channel, const type* input, type* output, int numSamples)
+    {
+        auto evenHistoryLength = stage.numTaps - 1 + stage.extraDelay;
+        auto oddHistoryLength = stage.numTaps / 2 + stage.extraDelay;
+        auto even = stage.evenHistory.getChannelData(channel);
+        auto odd = stage.oddHistory.getChannelData(channel);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            even[evenHistoryLength + sample] = input[2 * sample];
+            odd[oddHistoryLength + sample] = input[2 * sample + 1];
+        }
+        kernels->convolve(output, even, stage.coefficients.data(), stage.numTaps, numSamples);
+        kernels->multiplyByValue(output, 0.5, numSamples);
+        kernels->addScaled(output, odd, 0.5, numSamples);
+        std::copy(even + numSamples, even + numSamples + evenHistoryLength, even);
+        std::copy(odd + numSamples, odd + numSamples + oddHistoryLength, odd);
+    }
+    
+    std::vector<Stage> stages;
+    int numStages = 0;
+    int latency = 0;
+    const VectorOperations<type>* kernels = nullptr;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_OVERSAMPLER_HEADER_INCLUDED
@@ -0,0 +1,121 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_PARAMETER_EVENT_QUEUE_HEADER_INCLUDED
+#define DSPTOOLS_PARAMETER_EVENT_QUEUE_HEADER_INCLUDED
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace DSPTools {
+
+/** A wait-free single producer, single consumer queue of parameter changes that coalesces
+    repeated changes to the same parameter.
+ 
+    Each parameter has a slot holding its latest value and a pending flag. The producer writes
+    the slot and only queues the parameter index if it was not already pending, so however
+    often a parameter changes between two reads the consumer sees it once, with its latest
+    value. A parameter set to the value it already had is not queued at all. The ring never
+    holds more than one entry per parameter, so it can never be full.
+*/
+template <typename type>
+class ParameterEventQueue
+{
+public:
+    ParameterEventQueue() {}
+    ~ParameterEventQueue() {}
+    
+    /** Allocate the queue for a number of parameters with their starting values. This must not
+        be called while either thread is using the queue.
+    */
+    void setup(const std::vector<type>& initialValues)
+    {
+        numParameters = static_cast<int> (initialValues.size());
+        values.reset(new std::atomic<type>[numParameters]);
+        pending.reset(new std::atomic<bool>[numParameters]);
+        ring.reset(new int[numParameters]);
+        producerValues = initialValues;
+        for (int parameter = 0; parameter < numParameters; ++parameter) {
+            values[parameter].store(initialValues[parameter]);
+            pending[parameter].store(false);
+        }
+        head.store(0);
+        tail.store(0);
+    }
+    
+    /** Set the value of a parameter. Only the producer thread may call this.
+    */
+    void push(int parameter, type value)
+    {
+        assert(parameter >= 0 && parameter < numParameters);
+        if (producerValues[parameter] == value) {
+            return;
+        }
+        producerValues[parameter] = value;
+        values[parameter].store(value);
+        if (!pending[parameter].exchange(true)) {
+            auto position = tail.load(std::memory_order_relaxed);
+            ring[position % numParameters] = parameter;
+            tail.store(position + 1, std::memory_order_release);
+        }
+    }
+    
+    /** Take the next changed parameter and its latest value. Only the consumer thread may call
+        this. Returns false if no parameter has changed.
+    */
+    bool pop(int& parameter, type& value)
+    {
+        auto position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        parameter = ring[position % numParameters];
+        head.store(position + 1, std::memory_order_release);
+        // Clearing the flag before reading the value means a change made after this read is
+        // queued again rather than lost.
+        pending[parameter].store(false);
+        value = values[parameter].load();
+        return true;
+    }
+    
+    /** Get the latest value of a parameter. Either thread may call this.
+    */
+    type getLatestValue(int parameter) const
+    {
+        return values[parameter].load();
+    }
+    
+private:
+    std::unique_ptr<std::atomic<type>[]> values;
+    std::unique_ptr<std::atomic<bool>[]> pending;
+    std::unique_ptr<int[]> ring;
+    std::vector<type> producerValues;
+    std::atomic<unsigned long> head {0}, tail {0};
+    int numParameters = 0;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_PARAMETER_EVENT_QUEUE_HEADER_INCLUDED
@@ -0,0 +1,388 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_SIMD_REGISTER_HEADER_INCLUDED
+#define DSPTOOLS_SIMD_REGISTER_HEADER_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/** Define DSPTOOLS_USE_SCALAR_KERNELS to build every vector kernel with the scalar
+    reference implementation instead of SIMD instructions.
+*/
+#if ! defined (DSPTOOLS_USE_SCALAR_KERNELS)
+ #if defined (__x86_64__) || defined (_M_X64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define DSPTOOLS_HAS_X86_SIMD 1
+ #elif defined (__GNUC__) || defined (__clang__)
+  #define DSPTOOLS_HAS_GENERIC_VECTOR 1
+ #endif
+#endif
+
+/** The AVX2 and AVX-512 registers are always compiled on x86 so that they can be chosen
+    at runtime. GCC and Clang need each function that uses them to be marked with its target.
+*/
+#if defined (__GNUC__) || defined (__clang__)
+ #define DSPTOOLS_AVX2_TARGET __attribute__ ((target ("avx2")))
+ #define DSPTOOLS_AVX512_TARGET __attribute__ ((target ("avx512f")))
+#else
+ #define DSPTOOLS_AVX2_TARGET
+ #define DSPTOOLS_AVX512_TARGET
+#endif
+
+#if defined (DSPTOOLS_HAS_X86_SIMD)
+ #include <immintrin.h>
+#endif
+
+namespace DSPTools {
+
+/** Instruction set tags used to select a SIMDRegister implementation.
+*/
+struct ScalarInstructions {};
+struct SSE2Instructions {};
+struct AVX2Instructions {};
+struct AVX512Instructions {};
+struct GenericVectorInstructions {};
+
+/** The layout of the bits of a floating point type, used by the exponent and mantissa functions.
+*/
+template <typename type>
+struct FloatBits
+{
+    using integer = typename std::conditional<sizeof (type) == 4, std::int32_t, std::int64_t>::type;
+    static constexpr int mantissaBits = sizeof (type) == 4 ? 23 : 52;
+    static constexpr integer exponentBias = sizeof (type) == 4 ? 127 : 1023;
+    static constexpr integer mantissaMask = (integer (1) << mantissaBits) - 1;
+    static constexpr integer one = exponentBias << mantissaBits;
+};
+
+/** A thin wrapper around a SIMD register holding several samples of the given type.
+    The default implementation holds one sample and is the scalar reference that every
+    vector implementation must match.
+*/
+template <typename type, typename Instructions>
+struct SIMDRegister
+{
+    using vector = type;
+    using mask = bool;
+    static constexpr int size = 1;
+    
+    static vector load(const type* data) { return *data; }
+    static void store(type* data, vector value) { *data = value; }
+    static vector expand(type value) { return value; }
+    static vector add(vector a, vector b) { return a + b; }
+    static vector subtract(vector a, vector b) { return a - b; }
+    static vector multiply(vector a, vector b) { return a * b; }
+    static vector divide(vector a, vector b) { return a / b; }
+    static vector min(vector a, vector b) { return b < a ? b : a; }
+    static vector max(vector a, vector b) { return a < b ? b : a; }
+    static vector sqrt(vector a) { return std::sqrt(a); }
+    static vector truncate(vector a) { return std::trunc(a); }
+    static mask greaterThan(vector a, vector b) { return a > b; }
+    static vector select(mask condition, vector ifTrue, vector ifFalse) { return condition ? ifTrue : ifFalse; }
+    
+    /** Returns 2 to the power of a value that holds a whole number within the exponent range.
+    */
+    static vector powerOfTwo(vector wholeNumber)
+    {
+        auto bits = (static_cast<typename FloatBits<type>::integer> (wholeNumber) + FloatBits<type>::exponentBias) << FloatBits<type>::mantissaBits;
+        vector result;
+        std::memcpy(&result, &bits, sizeof (result));
+        return result;
+    }
+    
+    /** Returns the unbiased exponent of a positive normal value, i.e. floor(log2(value)).
+    */
+    static vector exponent(vector value)
+    {
+        typename FloatBits<type>::integer bits;
+        std::memcpy(&bits, &value, sizeof (bits));
+        return static_cast<vector> ((bits >> FloatBits<type>::mantissaBits) - FloatBits<type>::exponentBias);
+    }
+    
+    /** Returns a positive normal value scaled by a power of two into the range 1 to 2.
+    */
+    static vector mantissa(vector value)
+    {
+        typename FloatBits<type>::integer bits;
+        std::memcpy(&bits, &value, sizeof (bits));
+        bits = (bits & FloatBits<type>::mantissaMask) | FloatBits<type>::one;
+        std::memcpy(&value, &bits, sizeof (bits));
+        return value;
+    }
+};
+
+#if defined (DSPTOOLS_HAS_X86_SIMD)
+template <>
+struct SIMDRegister<float, SSE2Instructions>
+{
+    using vector = __m128;
+    using mask = __m128;
+    static constexpr int size = 4;
+    
+    static vector load(const float* data) { return _mm_loadu_ps(data); }
+    static void store(float* data, vector value) { _mm_storeu_ps(data, value); }
+    static vector expand(float value) { return _mm_set1_ps(value); }
+    static vector add(vector a, vector b) { return _mm_add_ps(a, b); }
+    static vector subtract(vector a, vector b) { return _mm_sub_ps(a, b); }
+    static vector multiply(vector a, vector b) { return _mm_mul_ps(a, b); }
+    static vector divide(vector a, vector b) { return _mm_div_ps(a, b); }
+    static vector min(vector a, vector b) { return _mm_min_ps(a, b); }
+    static vector max(vector a, vector b) { return _mm_max_ps(a, b); }
+    static vector sqrt(vector a) { return _mm_sqrt_ps(a); }
+    static vector truncate(vector a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a)); }
+    static mask greaterThan(vector a, vector b) { return _mm_cmpgt_ps(a, b); }
+    static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm_or_ps(_mm_and_ps(condition, ifTrue), _mm_andnot_ps(condition, ifFalse)); }
+    static vector powerOfTwo(vector wholeNumber) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(wholeNumber), _mm_set1_epi32(127)), 23)); }
+    static vector exponent(vector value) { return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(value), 23), _mm_set1_epi32(127))); }
+    static vector mantissa(vector value) { return _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(_mm_castps_si128(value), _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000))); }
+};
+
+template <>
+struct SIMDRegister<double, SSE2Instructions>
+{
+    using vector = __m128d;
+    using mask = __m128d;
+    static constexpr int size = 2;
+    
+    static vector load(const double* data) { return _mm_loadu_pd(data); }
+    static void store(double* data, vector value) { _mm_storeu_pd(data, value); }
+    static vector expand(double value) { return _mm_set1_pd(value); }
+    static vector add(vector a, vector b) { return _mm_add_pd(a, b); }
+    static vector subtract(vector a, vector b) { return _mm_sub_pd(a, b); }
+    static vector multiply(vector a, vector b) { return _mm_mul_pd(a, b); }
+    static vector divide(vector a, vector b) { return _mm_div_pd(a, b); }
+    static vector min(vector a, vector b) { return _mm_min_pd(a, b); }
+    static vector max(vector a, vector b) { return _mm_max_pd(a, b); }
+    static vector sqrt(vector a) { return _mm_sqrt_pd(a); }
+    static vector truncate(vector a) { return _mm_cvtepi32_pd(_mm_cvttpd_epi32(a)); }
+    static mask greaterThan(vector a, vector b) { return _mm_cmpgt_pd(a, b); }
+    static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm_or_pd(_mm_and_pd(condition, ifTrue), _mm_andnot_pd(condition, ifFalse)); }
+    
+    /** SSE2 has no 64 bit conversions, so whole numbers are moved between the float and
+        integer domains by adding 2^52 + 2^51, which puts them in the low mantissa bits.
+    */
+    static vector powerOfTwo(vector wholeNumber)
+    {
+        auto shifter = _mm_set1_pd(6755399441055744.0);
+        auto integer = _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(wholeNumber, shifter)), _mm_castpd_si128(shifter));
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(integer, _mm_set1_epi64x(1023)), 52));
+    }
+    static vector exponent(vector value)
+    {
+        auto shifter = _mm_set1_pd(4503599627370496.0);
+        auto biasedExponent = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(value), 52), _mm_castpd_si128(shifter)));
+        return _mm_sub_pd(_mm_sub_pd(biasedExponent, shifter), _mm_set1_pd(1023.0));
+    }
+    static vector mantissa(vector value) { return _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(_mm_castpd_si128(value), _mm_set1_epi64x(0x000fffffffffffffLL)), _mm_set1_epi64x(0x3ff0000000000000LL))); }
+};
+
+template <>
+struct SIMDRegister<float, AVX2Instructions>
+{
+    using vector = __m256;
+    using mask = __m256;
+    static constexpr int size = 8;
+    
+    DSPTOOLS_AVX2_TARGET static vector load(const float* data) { return _mm256_loadu_ps(data); }
+    DSPTOOLS_AVX2_TARGET static void store(float* data, vector value) { _mm256_storeu_ps(data, value); }
+    DSPTOOLS_AVX2_TARGET static vector expand(float value) { return _mm256_set1_ps(value); }
+    DSPTOOLS_AVX2_TARGET static vector add(vector a, vector b) { return _mm256_add_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector subtract(vector a, vector b) { return _mm256_sub_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector multiply(vector a, vector b) { return _mm256_mul_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector divide(vector a, vector b) { return _mm256_div_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector min(vector a, vector b) { return _mm256_min_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector max(vector a, vector b) { return _mm256_max_ps(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector sqrt(vector a) { return _mm256_sqrt_ps(a); }
+    DSPTOOLS_AVX2_TARGET static vector truncate(vector a) { return _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    DSPTOOLS_AVX2_TARGET static mask greaterThan(vector a, vector b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    DSPTOOLS_AVX2_TARGET static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, condition); }
+    DSPTOOLS_AVX2_TARGET static vector powerOfTwo(vector wholeNumber) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(wholeNumber), _mm256_set1_epi32(127)), 23)); }
+    DSPTOOLS_AVX2_TARGET static vector exponent(vector value) { return _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(value), 23), _mm256_set1_epi32(127))); }
+    DSPTOOLS_AVX2_TARGET static vector mantissa(vector value) { return _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(_mm256_castps_si256(value), _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f800000))); }
+};
+
+template <>
+struct SIMDRegister<double, AVX2Instructions>
+{
+    using vector = __m256d;
+    using mask = __m256d;
+    static constexpr int size = 4;
+    
+    DSPTOOLS_AVX2_TARGET static vector load(const double* data) { return _mm256_loadu_pd(data); }
+    DSPTOOLS_AVX2_TARGET static void store(double* data, vector value) { _mm256_storeu_pd(data, value); }
+    DSPTOOLS_AVX2_TARGET static vector expand(double value) { return _mm256_set1_pd(value); }
+    DSPTOOLS_AVX2_TARGET static vector add(vector a, vector b) { return _mm256_add_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector subtract(vector a, vector b) { return _mm256_sub_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector multiply(vector a, vector b) { return _mm256_mul_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector divide(vector a, vector b) { return _mm256_div_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector min(vector a, vector b) { return _mm256_min_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector max(vector a, vector b) { return _mm256_max_pd(a, b); }
+    DSPTOOLS_AVX2_TARGET static vector sqrt(vector a) { return _mm256_sqrt_pd(a); }
+    DSPTOOLS_AVX2_TARGET static vector truncate(vector a) { return _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    DSPTOOLS_AVX2_TARGET static mask greaterThan(vector a, vector b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    DSPTOOLS_AVX2_TARGET static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm256_blendv_pd(ifFalse, ifTrue, condition); }
+    DSPTOOLS_AVX2_TARGET static vector powerOfTwo(vector wholeNumber)
+    {
+        auto shifter = _mm256_set1_pd(6755399441055744.0);
+        auto integer = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(wholeNumber, shifter)), _mm256_castpd_si256(shifter));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(integer, _mm256_set1_epi64x(1023)), 52));
+    }
+    DSPTOOLS_AVX2_TARGET static vector exponent(vector value)
+    {
+        auto shifter = _mm256_set1_pd(4503599627370496.0);
+        auto biasedExponent = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(_mm256_castpd_si256(value), 52), _mm256_castpd_si256(shifter)));
+        return _mm256_sub_pd(_mm256_sub_pd(biasedExponent, shifter), _mm256_set1_pd(1023.0));
+    }
+    DSPTOOLS_AVX2_TARGET static vector mantissa(vector value) { return _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(_mm256_castpd_si256(value), _mm256_set1_epi64x(0x000fffffffffffffLL)), _mm256_set1_epi64x(0x3ff0000000000000LL))); }
+};
+
+// GCC implements several AVX-512 intrinsics by merging into _mm512_undefined_*, and warns
+// that the undefined register may be used wherever they are inlined.
+#if defined (__GNUC__) && ! defined (__clang__)
+ #pragma GCC diagnostic push
+ #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+template <>
+struct SIMDRegister<float, AVX512Instructions>
+{
+    using vector = __m512;
+    using mask = __mmask16;
+    static constexpr int size = 16;
+    
+    DSPTOOLS_AVX512_TARGET static vector load(const float* data) { return _mm512_loadu_ps(data); }
+    DSPTOOLS_AVX512_TARGET static void store(float* data, vector value) { _mm512_storeu_ps(data, value); }
+    DSPTOOLS_AVX512_TARGET static vector expand(float value) { return _mm512_set1_ps(value); }
+    DSPTOOLS_AVX512_TARGET static vector add(vector a, vector b) { return _mm512_add_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector subtract(vector a, vector b) { return _mm512_sub_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector multiply(vector a, vector b) { return _mm512_mul_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector divide(vector a, vector b) { return _mm512_div_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector min(vector a, vector b) { return _mm512_min_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector max(vector a, vector b) { return _mm512_max_ps(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector sqrt(vector a) { return _mm512_sqrt_ps(a); }
+    DSPTOOLS_AVX512_TARGET static vector truncate(vector a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    DSPTOOLS_AVX512_TARGET static mask greaterThan(vector a, vector b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    DSPTOOLS_AVX512_TARGET static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm512_mask_blend_ps(condition, ifFalse, ifTrue); }
+    DSPTOOLS_AVX512_TARGET static vector powerOfTwo(vector wholeNumber) { return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(_mm512_cvttps_epi32(wholeNumber), _mm512_set1_epi32(127)), 23)); }
+    DSPTOOLS_AVX512_TARGET static vector exponent(vector value) { return _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(_mm512_castps_si512(value), 23), _mm512_set1_epi32(127))); }
+    DSPTOOLS_AVX512_TARGET static vector mantissa(vector value) { return _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(_mm512_castps_si512(value), _mm512_set1_epi32(0x007fffff)), _mm512_set1_epi32(0x3f800000))); }
+};
+
+template <>
+struct SIMDRegister<double, AVX512Instructions>
+{
+    using vector = __m512d;
+    using mask = __mmask8;
+    static constexpr int size = 8;
+    
+    DSPTOOLS_AVX512_TARGET static vector load(const double* data) { return _mm512_loadu_pd(data); }
+    DSPTOOLS_AVX512_TARGET static void store(double* data, vector value) { _mm512_storeu_pd(data, value); }
+    DSPTOOLS_AVX512_TARGET static vector expand(double value) { return _mm512_set1_pd(value); }
+    DSPTOOLS_AVX512_TARGET static vector add(vector a, vector b) { return _mm512_add_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector subtract(vector a, vector b) { return _mm512_sub_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector multiply(vector a, vector b) { return _mm512_mul_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector divide(vector a, vector b) { return _mm512_div_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector min(vector a, vector b) { return _mm512_min_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector max(vector a, vector b) { return _mm512_max_pd(a, b); }
+    DSPTOOLS_AVX512_TARGET static vector sqrt(vector a) { return _mm512_sqrt_pd(a); }
+    DSPTOOLS_AVX512_TARGET static vector truncate(vector a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC); }
+    DSPTOOLS_AVX512_TARGET static mask greaterThan(vector a, vector b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    DSPTOOLS_AVX512_TARGET static vector select(mask condition, vector ifTrue, vector ifFalse) { return _mm512_mask_blend_pd(condition, ifFalse, ifTrue); }
+    DSPTOOLS_AVX512_TARGET static vector powerOfTwo(vector wholeNumber)
+    {
+        auto shifter = _mm512_set1_pd(6755399441055744.0);
+        auto integer = _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(wholeNumber, shifter)), _mm512_castpd_si512(shifter));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(integer, _mm512_set1_epi64(1023)), 52));
+    }
+    DSPTOOLS_AVX512_TARGET static vector exponent(vector value)
+    {
+        auto shifter = _mm512_set1_pd(4503599627370496.0);
+        auto biasedExponent = _mm512_castsi512_pd(_mm512_or_si512(_mm512_srli_epi64(_mm512_castpd_si512(value), 52), _mm512_castpd_si512(shifter)));
+        return _mm512_sub_pd(_mm512_sub_pd(biasedExponent, shifter), _mm512_set1_pd(1023.0));
+    }
+    DSPTOOLS_AVX512_TARGET static vector mantissa(vector value) { return _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(_mm512_castpd_si512(value), _mm512_set1_epi64(0x000fffffffffffffLL)), _mm512_set1_epi64(0x3ff0000000000000LL))); }
+};
+#if defined (__GNUC__) && ! defined (__clang__)
+ #pragma GCC diagnostic pop
+#endif
+#endif
+
+#if defined (DSPTOOLS_HAS_GENERIC_VECTOR)
+/** Uses the compiler's vector extensions, which map onto NEON on ARM targets.
+*/
+template <typename type>
+struct SIMDRegister<type, GenericVectorInstructions>
+{
+    typedef type vector __attribute__ ((vector_size (16)));
+    using mask = decltype (vector {} < vector {});
+    static constexpr int size = 16 / sizeof (type);
+    
+    static vector load(const type* data) { vector value; std::memcpy(&value, data, sizeof (vector)); return value; }
+    static void store(type* data, vector value) { std::memcpy(data, &value, sizeof (vector)); }
+    static vector expand(type value) { return vector {} + value; }
+    static vector add(vector a, vector b) { return a + b; }
+    static vector subtract(vector a, vector b) { return a - b; }
+    static vector multiply(vector a, vector b) { return a * b; }
+    static vector divide(vector a, vector b) { return a / b; }
+    static vector min(vector a, vector b) { return b < a ? b : a; }
+    static vector max(vector a, vector b) { return a < b ? b : a; }
+    static vector sqrt(vector a)
+    {
+        for (int index = 0; index < size; ++index) {
+            a[index] = std::sqrt(a[index]);
+        }
+        return a;
+    }
+    static vector truncate(vector a)
+    {
+        for (int index = 0; index < size; ++index) {
+            a[index] = std::trunc(a[index]);
+        }
+        return a;
+    }
+    static mask greaterThan(vector a, vector b) { return a > b; }
+    static vector select(mask condition, vector ifTrue, vector ifFalse) { return condition ? ifTrue : ifFalse; }
+    
+    typedef typename FloatBits<type>::integer integerVector __attribute__ ((vector_size (16)));
+    
+    static vector powerOfTwo(vector wholeNumber)
+    {
+        auto bits = (__builtin_convertvector (wholeNumber, integerVector) + FloatBits<type>::exponentBias) << FloatBits<type>::mantissaBits;
+        return reinterpret_cast<vector> (bits);
+    }
+    static vector exponent(vector value)
+    {
+        auto bits = reinterpret_cast<integerVector> (value);
+        return __builtin_convertvector ((bits >> FloatBits<type>::mantissaBits) - FloatBits<type>::exponentBias, vector);
+    }
+    static vector mantissa(vector value)
+    {
+        auto bits = reinterpret_cast<integerVector> (value);
+        return reinterpret_cast<vector> ((bits & FloatBits<type>::mantissaMask) | FloatBits<type>::one);
+    }
+};
+#endif
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_SIMD_REGISTER_HEADER_INCLUDED
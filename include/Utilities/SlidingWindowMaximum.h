@@ -0,0 +1,107 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_SLIDING_WINDOW_MAXIMUM_HEADER_INCLUDED
+#define DSPTOOLS_SLIDING_WINDOW_MAXIMUM_HEADER_INCLUDED
+
+#include <vector>
+
+namespace DSPTools {
+
+/** The maximum of the last windowSize values of a signal.
+    A monotonic deque holds only the values that can still become the maximum, so each
+    value is pushed and popped at most once and the cost per sample does not depend on
+    the window size.
+*/
+template <typename type>
+class SlidingWindowMaximum
+{
+public:
+    SlidingWindowMaximum() {}
+    ~SlidingWindowMaximum() {}
+    
+    /** Setup the window. This allocates the deque and must be called before calling process.
+    */
+    void setup(int maxWindowSize)
+    {
+        assert(maxWindowSize > 0);
+        values.resize(maxWindowSize + 1);
+        indices.resize(maxWindowSize + 1);
+        setWindowSize(maxWindowSize);
+    }
+    
+    /** Set the number of values the maximum is taken over. This also resets the window.
+    */
+    void setWindowSize(int newWindowSize)
+    {
+        assert(newWindowSize > 0 && newWindowSize < static_cast<int> (values.size()));
+        windowSize = newWindowSize;
+        reset();
+    }
+    
+    /** Empty the window.
+    */
+    void reset()
+    {
+        front = 0;
+        back = 0;
+        sampleIndex = 0;
+    }
+    
+    /** Add a value to the window and return the maximum of the window.
+    */
+    type process(type value)
+    {
+        while (back != front && values[previous(back)] <= value) {
+            back = previous(back);
+        }
+        values[back] = value;
+        indices[back] = sampleIndex;
+        back = next(back);
+        
+        if (sampleIndex - indices[front] >= static_cast<unsigned long> (windowSize)) {
+            front = next(front);
+        }
+        ++sampleIndex;
+        return values[front];
+    }
+    
+private:
+    int next(int position)
+    {
+        return (position + 1 == static_cast<int> (values.size())) ? 0 : position + 1;
+    }
+    
+    int previous(int position)
+    {
+        return (position == 0) ? static_cast<int> (values.size()) - 1 : position - 1;
+    }
+    
+    std::vector<type> values;
+    std::vector<unsigned long> indices;
+    unsigned long sampleIndex = 0;
+    int windowSize = 1, front = 0, back = 0;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_SLIDING_WINDOW_MAXIMUM_HEADER_INCLUDED
@@ -23,13 +23,24 @@ SOFTWARE.*/
 #ifndef DSPTOOLS_SMOOTHED_VALUE_HEADER_INCLUDED
 #define DSPTOOLS_SMOOTHED_VALUE_HEADER_INCLUDED
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include "VectorOperations.h"
 
 namespace DSPTools {
 
+/** A value that moves to each new target over a fixed smoothing time.
+    In linear mode the value moves by equal steps. In exponential mode it is multiplied by the
+    same ratio each sample, which sounds even for gains in the amplitude domain; a ramp that
+    starts or ends at zero, or crosses it, cannot be exponential and falls back to linear.
+    Every ramp ends exactly on its target.
+*/
 template <typename type>
 class SmoothedValue {
 public:
+    enum Mode {linear, exponential};
+    
     SmoothedValue()
     {
         static_assert(std::is_floating_point<type>::value, "Smoothed Value: Not a floating point type.");
@@ -44,10 +55,15 @@ public:
         assert(sampleRate > 0.0);
         this->sampleRate = sampleRate;
         this->smoothingTime = smoothingTime;
-        currentValue = initialValue;
-        targetValue = initialValue;
-        incrementValue = 0.0;
-        countdown = 0;
+        setCurrentAndTargetValue(initialValue);
+        kernels = &VectorOperations<type>::getBest();
+    }
+    
+    /** Set whether new ramps are linear or exponential. A ramp in progress is not changed.
+    */
+    void setMode(Mode newMode)
+    {
+        mode = newMode;
     }
     
     /** Set the value that should be smoothed towards.
@@ -59,16 +75,18 @@ public:
         }
         targetValue = newTarget;
         
-        if (targetValue != currentValue)
-        {
-            if (smoothingTime > 0.0) {
-                incrementValue = (targetValue - currentValue) / (smoothingTime * sampleRate);
-                countdown = smoothingTime * sampleRate;
-            } else
-            {
-                incrementValue = (targetValue - currentValue);
-                countdown = 1;
-            }
+        if (targetValue == currentValue) {
+            countdown = 0;
+            return;
+        }
+        numSteps = std::max(1u, static_cast<unsigned int> (smoothingTime * sampleRate));
+        countdown = numSteps;
+        rampStart = currentValue;
+        isMultiplicative = mode == exponential && currentValue * targetValue > 0.0;
+        if (isMultiplicative) {
+            incrementValue = std::pow(targetValue / currentValue, type (1.0) / numSteps);
+        } else {
+            incrementValue = (targetValue - currentValue) / numSteps;
         }
     }
     
@@ -79,23 +97,92 @@ public:
         targetValue = value;
         currentValue = value;
         incrementValue = 0.0;
+        countdown = 0;
     }
     
     /** Set the next smoothed value.
     */
     type getNextValue()
     {
-        if (countdown <= 0)
+        if (countdown == 0)
         {
             return currentValue;
         }
         
         --countdown;
-        currentValue += incrementValue;
+        if (countdown == 0) {
+            currentValue = targetValue;
+        } else if (isMultiplicative) {
+            currentValue *= incrementValue;
+        } else {
+            currentValue = rampStart + type (numSteps - countdown) * incrementValue;
+        }
         
         return currentValue;
     }
     
+    /** Write the next numSamples values to a buffer, giving the same values as calling
+        getNextValue for each sample to within rounding. The moving part of the ramp is written
+        with the SIMD kernels and the rest is filled with the target. Before setup there are no
+        kernels, so every value comes from getNextValue.
+    */
+    void fillRamp(type* dest, int numSamples)
+    {
+        if (kernels == nullptr) {
+            for (int sample = 0; sample < numSamples; ++sample) {
+                dest[sample] = getNextValue();
+            }
+            return;
+        }
+        int numRampSamples = static_cast<int> (std::min(countdown, static_cast<unsigned int> (std::max(numSamples, 0))));
+        if (numRampSamples > 0) {
+            if (isMultiplicative) {
+                currentValue = kernels->exponentialRamp(dest, numRampSamples, currentValue, incrementValue);
+            } else {
+                kernels->linearRamp(dest, numRampSamples, rampStart, incrementValue, numSteps - countdown + 1);
+                currentValue = dest[numRampSamples - 1];
+            }
+            countdown -= numRampSamples;
+            if (countdown == 0) {
+                currentValue = targetValue;
+                dest[numRampSamples - 1] = targetValue;
+            }
+        }
+        std::fill(dest + numRampSamples, dest + numSamples, currentValue);
+    }
+    
+    /** Advance the smoothed value by a number of samples without returning the values.
+    */
+    void skip(int numSamples)
+    {
+        auto numSkipped = std::min(countdown, static_cast<unsigned int> (std::max(numSamples, 0)));
+        if (numSkipped == 0) {
+            return;
+        }
+        countdown -= numSkipped;
+        if (countdown == 0) {
+            currentValue = targetValue;
+        } else if (isMultiplicative) {
+            currentValue *= std::pow(incrementValue, type (numSkipped));
+        } else {
+            currentValue = rampStart + type (numSteps - countdown) * incrementValue;
+        }
+    }
+    
+    /** Returns true if the value is still moving towards its target.
+    */
+    bool isSmoothing()
+    {
+        return countdown > 0;
+    }
+    
+    /** Returns the number of samples until the value reaches its target.
+    */
+    int remainingSamples()
+    {
+        return static_cast<int> (countdown);
+    }
+    
     /** Get the value that is being smoothed towards.
     */
     type getTargetValue()
@@ -111,9 +198,12 @@ public:
     }
     
 private:
-    type currentValue = 0.0, targetValue = 0.0, incrementValue = 0.0, smoothingTime = 0.0;
-    unsigned int countdown = 0;
+    type currentValue = 0.0, targetValue = 0.0, incrementValue = 0.0, smoothingTime = 0.0, rampStart = 0.0;
+    unsigned int countdown = 0, numSteps = 0;
     double sampleRate = 1.0;
+    Mode mode = linear;
+    bool isMultiplicative = false;
+    const VectorOperations<type>* kernels = nullptr;
 };
 
 } // namespace DSPTools
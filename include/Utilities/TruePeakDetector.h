@@ -0,0 +1,123 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_TRUE_PEAK_DETECTOR_HEADER_INCLUDED
+#define DSPTOOLS_TRUE_PEAK_DETECTOR_HEADER_INCLUDED
+
+#include <vector>
+#include "Maths.h"
+
+namespace DSPTools {
+
+/** Estimates the peaks between samples by 4x polyphase oversampling, following the
+    interpolation approach of ITU-R BS.1770.
+    The interpolation filter is a 48 tap Blackman windowed sinc, calculated in setup. Its
+    centre tap falls on an input sample, so the detector output is delayed by exactly
+    getLatencyInSamples samples.
+*/
+template <typename type>
+class TruePeakDetector
+{
+public:
+    TruePeakDetector() {}
+    ~TruePeakDetector() {}
+    
+    /** Setup the detector. This must be called before calling process.
+    */
+    void setup(int numChannels)
+    {
+        assert(numChannels > 0);
+        for (int phase = 1; phase < numPhases; ++phase) {
+            type sum = 0.0;
+            for (int tap = 0; tap < tapsPerPhase; ++tap) {
+                auto index = phase + tap * numPhases;
+                auto time = (index - latency * numPhases) / static_cast<double> (numPhases);
+                auto sinc = std::sin(Maths<double>::pi * time) / (Maths<double>::pi * time);
+                auto window = 0.42 - 0.5 * std::cos(2.0 * Maths<double>::pi * index / (numPhases * tapsPerPhase))
+                                   + 0.08 * std::cos(4.0 * Maths<double>::pi * index / (numPhases * tapsPerPhase));
+                coefficients[phase - 1][tap] = static_cast<type> (sinc * window);
+                sum += coefficients[phase - 1][tap];
+            }
+            // Normalising each phase keeps a constant signal at exactly the same level.
+            for (int tap = 0; tap < tapsPerPhase; ++tap) {
+                coefficients[phase - 1][tap] /= sum;
+            }
+        }
+        history.resize(numChannels);
+        positions.resize(numChannels);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            history[channel].resize(2 * tapsPerPhase);
+        }
+        reset();
+    }
+    
+    /** Clear the interpolation history of all channels.
+    */
+    void reset()
+    {
+        for (int channel = 0; channel < static_cast<int> (history.size()); ++channel) {
+            std::fill(history[channel].begin(), history[channel].end(), type (0.0));
+            positions[channel] = 0;
+        }
+    }
+    
+    /** Add a sample and return the largest absolute value of the signal between the samples
+        getLatencyInSamples and getLatencyInSamples - 1 samples ago, including both.
+    */
+    type process(type value, int channel)
+    {
+        auto& position = positions[channel];
+        position = (position == 0) ? tapsPerPhase - 1 : position - 1;
+        history[channel][position] = value;
+        history[channel][position + tapsPerPhase] = value;
+        
+        // window[tap] is the sample from tap samples ago.
+        const type* window = history[channel].data() + position;
+        type peak = std::max(std::abs(window[latency]), std::abs(window[latency - 1]));
+        for (int phase = 0; phase < numPhases - 1; ++phase) {
+            type interpolated = 0.0;
+            for (int tap = 0; tap < tapsPerPhase; ++tap) {
+                interpolated += coefficients[phase][tap] * window[tap];
+            }
+            peak = std::max(peak, type (std::abs(interpolated)));
+        }
+        return peak;
+    }
+    
+    /** Get the delay of the detector output in samples.
+    */
+    static constexpr int getLatencyInSamples()
+    {
+        return latency;
+    }
+    
+private:
+    static constexpr int numPhases = 4, tapsPerPhase = 12, latency = tapsPerPhase / 2;
+    
+    type coefficients[numPhases - 1][tapsPerPhase];
+    std::vector<std::vector<type>> history;
+    std::vector<int> positions;
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_TRUE_PEAK_DETECTOR_HEADER_INCLUDED
@@ -0,0 +1,768 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+/*  The kernels in this file are compiled once for each instruction set. VectorOperations.h
+    includes it inside a namespace for each instruction set, with DSPTOOLS_KERNEL_INSTRUCTIONS
+    set to that instruction set's tag, so it deliberately has no include guard.
+*/
+
+template <typename type>
+class Kernels
+{
+public:
+    using Register = SIMDRegister<type, DSPTOOLS_KERNEL_INSTRUCTIONS>;
+    using Scalar = SIMDRegister<type, ScalarInstructions>;
+    
+    /** Multiply a buffer of samples by a buffer of values.
+    */
+    static void multiply(type* data, const type* values, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, Register::multiply(Register::load(data + sample), Register::load(values + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] *= values[sample];
+        }
+    }
+    
+    /** Multiply a buffer of samples by a single value.
+    */
+    static void multiplyByValue(type* data, type value, int numSamples)
+    {
+        auto values = Register::expand(value);
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, Register::multiply(Register::load(data + sample), values));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] *= value;
+        }
+    }
+    
+    /** Add a buffer of samples multiplied by a gain to another buffer.
+    */
+    static void addScaled(type* dest, const type* source, type gain, int numSamples)
+    {
+        auto gains = Register::expand(gain);
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(dest + sample, Register::add(Register::load(dest + sample), Register::multiply(gains, Register::load(source + sample))));
+        }
+        for (; sample < numSamples; ++sample) {
+            dest[sample] += gain * source[sample];
+        }
+    }
+    
+    /** Filter a buffer with an FIR filter, writing the sum of coefficients[tap] * source[sample + tap]
+        over the taps to each dest[sample]. source holds numTaps - 1 samples of history before the
+        samples of the block, so the coefficients are in reverse time order. Four registers of
+        output are worked on at once to hide the latency of the additions.
+    */
+    static void convolve(type* dest, const type* source, const type* coefficients, int numTaps, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + 4 * Register::size <= numSamples; sample += 4 * Register::size) {
+            auto sum0 = Register::expand(0.0), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+            auto input = source + sample;
+            for (int tap = 0; tap < numTaps; ++tap) {
+                auto coefficient = Register::expand(coefficients[tap]);
+                sum0 = Register::add(sum0, Register::multiply(coefficient, Register::load(input + tap)));
+                sum1 = Register::add(sum1, Register::multiply(coefficient, Register::load(input + tap + Register::size)));
+                sum2 = Register::add(sum2, Register::multiply(coefficient, Register::load(input + tap + 2 * Register::size)));
+                sum3 = Register::add(sum3, Register::multiply(coefficient, Register::load(input + tap + 3 * Register::size)));
+            }
+            Register::store(dest + sample, sum0);
+            Register::store(dest + sample + Register::size, sum1);
+            Register::store(dest + sample + 2 * Register::size, sum2);
+            Register::store(dest + sample + 3 * Register::size, sum3);
+        }
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            auto sum = Register::expand(0.0);
+            for (int tap = 0; tap < numTaps; ++tap) {
+                sum = Register::add(sum, Register::multiply(Register::expand(coefficients[tap]), Register::load(source + sample + tap)));
+            }
+            Register::store(dest + sample, sum);
+        }
+        for (; sample < numSamples; ++sample) {
+            type sum = 0.0;
+            for (int tap = 0; tap < numTaps; ++tap) {
+                sum += coefficients[tap] * source[sample + tap];
+            }
+            dest[sample] = sum;
+        }
+    }
+    
+    /** Convert a buffer of pan positions from -1 to 1 into equal power channel gains.
+        The left channel gain is sqrt(0.5 - pan / 2) and the right channel gain is sqrt(0.5 + pan / 2).
+    */
+    static void panPositionsToGains(type* values, int numSamples, bool leftChannel)
+    {
+        type scale = leftChannel ? -0.5 : 0.5;
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            auto amplitude = Register::add(Register::expand(0.5), Register::multiply(Register::expand(scale), Register::load(values + sample)));
+            Register::store(values + sample, Register::sqrt(Register::max(Register::expand(0.0), amplitude)));
+        }
+        for (; sample < numSamples; ++sample) {
+            values[sample] = Scalar::sqrt(Scalar::max(0.0, 0.5 + scale * values[sample]));
+        }
+    }
+    
+    /** Follow the envelope of several channels at once, one channel per register lane.
+        The state holds the last envelope value of each channel, or its square in rms mode, and is updated in place.
+    */
+    static void followEnvelopes(const type* const* input, type* const* output, type* state, int numChannels, int numSamples, type attackCoefficient, type releaseCoefficient, bool rms)
+    {
+        int channel = 0;
+        for (; channel + Register::size <= numChannels; channel += Register::size) {
+            if (rms) {
+                followEnvelopeGroup<Register, true>(input + channel, output + channel, state + channel, numSamples, attackCoefficient, releaseCoefficient);
+            } else {
+                followEnvelopeGroup<Register, false>(input + channel, output + channel, state + channel, numSamples, attackCoefficient, releaseCoefficient);
+            }
+        }
+        for (; channel < numChannels; ++channel) {
+            if (rms) {
+                followEnvelopeGroup<Scalar, true>(input + channel, output + channel, state + channel, numSamples, attackCoefficient, releaseCoefficient);
+            } else {
+                followEnvelopeGroup<Scalar, false>(input + channel, output + channel, state + channel, numSamples, attackCoefficient, releaseCoefficient);
+            }
+        }
+    }
+    
+    /** Run a biquad filter in transposed direct form II over each channel in place, with the
+        channels side by side in the lanes of a register. coefficients holds b0, b1, b2, a1 and
+        a2, normalised so that a0 is 1, and increments holds the amount each coefficient moves
+        by before every sample, so a block can glide to new coefficients. state holds the first
+        state variable of every channel followed by the second.
+    */
+    static void filterBiquads(type* const* data, type* state, int numChannels, int numSamples, const type* coefficients, const type* increments)
+    {
+        bool isRamping = std::any_of(increments, increments + 5, [] (type increment) { return increment != 0.0; });
+        int channel = 0;
+        for (; channel + Register::size <= numChannels; channel += Register::size) {
+            if (isRamping) {
+                filterBiquadGroup<Register, true>(data + channel, state + channel, state + numChannels + channel, numSamples, coefficients, increments);
+            } else {
+                filterBiquadGroup<Register, false>(data + channel, state + channel, state + numChannels + channel, numSamples, coefficients, increments);
+            }
+        }
+        for (; channel < numChannels; ++channel) {
+            if (isRamping) {
+                filterBiquadGroup<Scalar, true>(data + channel, state + channel, state + numChannels + channel, numSamples, coefficients, increments);
+            } else {
+                filterBiquadGroup<Scalar, false>(data + channel, state + channel, state + numChannels + channel, numSamples, coefficients, increments);
+            }
+        }
+    }
+    
+    /** Run a cascade of numStages biquad filters over each channel, reading from input and
+        writing to output, with the channels side by side in the lanes of a register. Unlike
+        filterBiquads every channel has its own coefficients, so one pass can run different
+        filters on each channel. Stage s keeps coefficient k of every channel at
+        coefficients[(5 * s + k) * numChannels], in the order b0, b1, b2, a1 and a2, and its two
+        state variables of every channel at state[2 * s * numChannels] and
+        state[(2 * s + 1) * numChannels]. increments may be null, or hold the amount each
+        coefficient moves by before every sample in the same layout, so a block can glide to new
+        coefficients. Each coefficient is calculated from its step, so no error builds up.
+    */
+    static void filterBiquadCascades(const type* const* input, type* const* output, type* state, int numChannels, int numSamples, const type* coefficients, const type* increments, int numStages)
+    {
+        int channel = 0;
+        for (; channel + Register::size <= numChannels; channel += Register::size) {
+            if (increments != nullptr) {
+                filterBiquadCascadeGroup<Register, true>(input + channel, output + channel, state + channel, numChannels, numSamples, coefficients + channel, increments + channel, numStages);
+            } else {
+                filterBiquadCascadeGroup<Register, false>(input + channel, output + channel, state + channel, numChannels, numSamples, coefficients + channel, nullptr, numStages);
+            }
+        }
+        for (; channel < numChannels; ++channel) {
+            if (increments != nullptr) {
+                filterBiquadCascadeGroup<Scalar, true>(input + channel, output + channel, state + channel, numChannels, numSamples, coefficients + channel, increments + channel, numStages);
+            } else {
+                filterBiquadCascadeGroup<Scalar, false>(input + channel, output + channel, state + channel, numChannels, numSamples, coefficients + channel, nullptr, numStages);
+            }
+        }
+    }
+    
+    /** Fill a buffer with oscillator phases from 0 to 1, starting at the given phase.
+        Returns the phase that follows the last one written.
+    */
+    static type generatePhases(type* dest, int numSamples, type phase, type increment)
+    {
+        int sample = 0;
+        if (Register::size > 1) {
+            type offsets[Register::size];
+            for (int lane = 0; lane < Register::size; ++lane) {
+                offsets[lane] = lane * increment;
+            }
+            auto laneOffsets = Register::load(offsets);
+            type step = Register::size * increment;
+            for (; sample + Register::size <= numSamples; sample += Register::size) {
+                auto phases = Register::add(Register::expand(phase), laneOffsets);
+                Register::store(dest + sample, Register::subtract(phases, Register::truncate(phases)));
+                phase += step;
+                phase -= Scalar::truncate(phase);
+            }
+        }
+        for (; sample < numSamples; ++sample) {
+            dest[sample] = phase;
+            phase += increment;
+            while (phase >= 1.0) {
+                phase -= 1.0;
+            }
+        }
+        return phase;
+    }
+    
+    /** Write the steps of a linear ramp, dest[i] = start + (firstStep + i) * increment. Each value
+        is calculated from its step rather than by adding up increments, so no error builds up
+        along the ramp.
+    */
+    static void linearRamp(type* dest, int numSamples, type start, type increment, int firstStep)
+    {
+        int sample = 0;
+        if (Register::size > 1) {
+            type steps[Register::size];
+            for (int lane = 0; lane < Register::size; ++lane) {
+                steps[lane] = type (firstStep + lane);
+            }
+            auto laneSteps = Register::load(steps);
+            auto starts = Register::expand(start);
+            auto increments = Register::expand(increment);
+            auto stride = Register::expand(type (Register::size));
+            for (; sample + Register::size <= numSamples; sample += Register::size) {
+                Register::store(dest + sample, Register::add(starts, Register::multiply(laneSteps, increments)));
+                laneSteps = Register::add(laneSteps, stride);
+            }
+        }
+        for (; sample < numSamples; ++sample) {
+            dest[sample] = start + type (firstStep + sample) * increment;
+        }
+    }
+    
+    /** Write the steps of an exponential ramp, multiplying the value by the multiplier for each
+        sample, and return the last value written.
+    */
+    static type exponentialRamp(type* dest, int numSamples, type value, type multiplier)
+    {
+        int sample = 0;
+        if (Register::size > 1) {
+            type powers[Register::size];
+            powers[0] = multiplier;
+            for (int lane = 1; lane < Register::size; ++lane) {
+                powers[lane] = powers[lane - 1] * multiplier;
+            }
+            auto lanePowers = Register::load(powers);
+            for (; sample + Register::size <= numSamples; sample += Register::size) {
+                Register::store(dest + sample, Register::multiply(Register::expand(value), lanePowers));
+                value = dest[sample + Register::size - 1];
+            }
+        }
+        for (; sample < numSamples; ++sample) {
+            value *= multiplier;
+            dest[sample] = value;
+        }
+        return value;
+    }
+    
+    /** Apply the tanh estimation from Waveshapers to a buffer of samples.
+    */
+    static void tanHEstimate(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, tanHEstimate<Register>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = tanHEstimate<Scalar>(data[sample]);
+        }
+    }
+    
+    /** Replace each value in a buffer with the linear interpolation of a table of a function,
+        sampled at numPoints points from start in steps of step. Values outside the table take
+        the value at its nearest end.
+    */
+    static void interpolateTable(type* data, const type* table, int numPoints, type start, type step, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, interpolateTable<Register>(Register::load(data + sample), table, numPoints, start, step));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = interpolateTable<Scalar>(data[sample], table, numPoints, start, step);
+        }
+    }
+    
+    /** Replace each value in a buffer with the integral of the function that interpolateTable
+        gives for the same table, where integrals holds the integral at each point of the table.
+        Between the points the integral is the exact quadratic of the linear interpolation, and
+        outside the table it continues as a straight line.
+    */
+    static void integrateTable(type* data, const type* table, const type* integrals, int numPoints, type start, type step, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, integrateTable<Register>(Register::load(data + sample), table, integrals, numPoints, start, step));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = integrateTable<Scalar>(data[sample], table, integrals, numPoints, start, step);
+        }
+    }
+    
+    /** Raise 2 to the power of each value in a buffer.
+    */
+    template <typename Accuracy>
+    static void exp2(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, approximateExp2<Register, Accuracy>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = approximateExp2<Scalar, Accuracy>(data[sample]);
+        }
+    }
+    
+    /** Take the base 2 logarithm of each value in a buffer.
+    */
+    template <typename Accuracy>
+    static void log2(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, approximateLog2<Register, Accuracy>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = approximateLog2<Scalar, Accuracy>(data[sample]);
+        }
+    }
+    
+    /** Replace each phase value in a buffer with the value of a sine wave at that phase, where 1 is a full cycle.
+    */
+    template <typename Accuracy>
+    static void sine(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, approximateSine<Register, Accuracy>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = approximateSine<Scalar, Accuracy>(data[sample]);
+        }
+    }
+    
+    /** Convert a buffer of dBFS values to amplitudes.
+    */
+    template <typename Accuracy>
+    static void decibelsToAmplitude(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, approximateDecibelsToAmplitude<Register, Accuracy>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = approximateDecibelsToAmplitude<Scalar, Accuracy>(data[sample]);
+        }
+    }
+    
+    /** Convert a buffer of amplitudes to dBFS values.
+    */
+    template <typename Accuracy>
+    static void amplitudeToDecibels(type* data, int numSamples)
+    {
+        int sample = 0;
+        for (; sample + Register::size <= numSamples; sample += Register::size) {
+            Register::store(data + sample, approximateAmplitudeToDecibels<Register, Accuracy>(Register::load(data + sample)));
+        }
+        for (; sample < numSamples; ++sample) {
+            data[sample] = approximateAmplitudeToDecibels<Scalar, Accuracy>(data[sample]);
+        }
+    }
+    
+    /** Render a bank of oscillators into one buffer per voice, one voice per register lane.
+        The phases from 0 to 1 are advanced in place. The waveshapes hold the values of the
+        OscillatorBank Waveshape enum, and each voice is scaled by its gain.
+    */
+    template <typename Accuracy>
+    static void renderOscillators(type* phases, const type* increments, const type* waveshapes, const type* gains, type* const* outputs, int numVoices, int numSamples)
+    {
+        int voice = 0;
+        for (; voice + Register::size <= numVoices; voice += Register::size) {
+            renderOscillatorGroup<Register, Accuracy>(phases + voice, increments + voice, waveshapes + voice, gains + voice, outputs + voice, numSamples);
+        }
+        for (; voice < numVoices; ++voice) {
+            renderOscillatorGroup<Scalar, Accuracy>(phases + voice, increments + voice, waveshapes + voice, gains + voice, outputs + voice, numSamples);
+        }
+    }
+    
+    /** Render a bank of oscillators and write the sum of all the voices to dest.
+        The voices are processed together, one per register lane, for each sample in turn.
+    */
+    template <typename Accuracy>
+    static void sumOscillators(type* phases, const type* increments, const type* waveshapes, const type* gains, type* dest, int numVoices, int numSamples)
+    {
+        bool isSineOnly = true;
+        for (int voice = 0; voice < numVoices; ++voice) {
+            isSineOnly &= (waveshapes[voice] == 0.0);
+        }
+        if (isSineOnly) {
+            sumOscillatorBlock<Accuracy, true>(phases, increments, waveshapes, gains, dest, numVoices, numSamples);
+        } else {
+            sumOscillatorBlock<Accuracy, false>(phases, increments, waveshapes, gains, dest, numVoices, numSamples);
+        }
+    }
+    
+    /** 2 to the power of x. Inputs are limited to the normal exponent range of the type.
+    */
+    template <typename Reg, typename Accuracy>
+    static typename Reg::vector approximateExp2(typename Reg::vector x)
+    {
+        if constexpr (std::is_same<Accuracy, ExactAccuracy>::value) {
+            return applyToLanes<Reg>(x, [] (type value) { return std::exp2(value); });
+        } else {
+            constexpr type maxExponent = FloatBits<type>::exponentBias - 1;
+            x = Reg::max(Reg::expand(-maxExponent), Reg::min(Reg::expand(maxExponent), x));
+            auto wholePart = floor<Reg>(x);
+            auto fraction = Reg::subtract(x, wholePart);
+            auto polynomial = evaluatePolynomial<Reg>(Accuracy::exp2Coefficients, Accuracy::exp2Order, fraction);
+            polynomial = Reg::add(Reg::expand(1.0), Reg::multiply(polynomial, fraction));
+            return Reg::multiply(polynomial, Reg::powerOfTwo(wholePart));
+        }
+    }
+    
+    /** The base 2 logarithm of x. Values below the smallest normal value of the type are treated as that value.
+    */
+    template <typename Reg, typename Accuracy>
+    static typename Reg::vector approximateLog2(typename Reg::vector x)
+    {
+        if constexpr (std::is_same<Accuracy, ExactAccuracy>::value) {
+            return applyToLanes<Reg>(x, [] (type value) { return std::log2(value); });
+        } else {
+            x = Reg::max(Reg::expand(std::numeric_limits<type>::min()), x);
+            auto fraction = Reg::subtract(Reg::mantissa(x), Reg::expand(1.0));
+            auto polynomial = evaluatePolynomial<Reg>(Accuracy::log2Coefficients, Accuracy::log2Order, fraction);
+            return Reg::add(Reg::exponent(x), Reg::multiply(polynomial, fraction));
+        }
+    }
+    
+    /** sin(2 * pi * phase). The phase must be within the range of a 32 bit integer.
+    */
+    template <typename Reg, typename Accuracy>
+    static typename Reg::vector approximateSine(typename Reg::vector phase)
+    {
+        if constexpr (std::is_same<Accuracy, ExactAccuracy>::value) {
+            return applyToLanes<Reg>(phase, [] (type value) { return static_cast<type> (std::sin(value * 2.0 * 3.141592653589793238)); });
+        } else {
+            // Wrap to -0.5 to 0.5 and then fold to -0.25 to 0.25, where the sine is odd and monotonic.
+            phase = Reg::subtract(phase, floor<Reg>(Reg::add(phase, Reg::expand(0.5))));
+            phase = Reg::select(Reg::greaterThan(phase, Reg::expand(0.25)), Reg::subtract(Reg::expand(0.5), phase), phase);
+            phase = Reg::select(Reg::greaterThan(Reg::expand(-0.25), phase), Reg::subtract(Reg::expand(-0.5), phase), phase);
+            auto polynomial = evaluatePolynomial<Reg>(Accuracy::sineCoefficients, Accuracy::sineOrder, Reg::multiply(phase, phase));
+            return Reg::multiply(polynomial, phase);
+        }
+    }
+    
+    /** Converts dBFS to amplitude, where 1 = 0dBFS.
+    */
+    template <typename Reg, typename Accuracy>
+    static typename Reg::vector approximateDecibelsToAmplitude(typename Reg::vector dB)
+    {
+        if constexpr (std::is_same<Accuracy, ExactAccuracy>::value) {
+            return applyToLanes<Reg>(dB, [] (type value) { return static_cast<type> (std::pow(type(10.0), value * type(0.05))); });
+        } else {
+            return approximateExp2<Reg, Accuracy>(Reg::multiply(dB, Reg::expand(0.16609640474436811739)));
+        }
+    }
+    
+    /** Converts amplitude to dBFS, where 1 = 0dBFS.
+    */
+    template <typename Reg, typename Accuracy>
+    static typename Reg::vector approximateAmplitudeToDecibels(typename Reg::vector amplitude)
+    {
+        if constexpr (std::is_same<Accuracy, ExactAccuracy>::value) {
+            return applyToLanes<Reg>(amplitude, [] (type value) { return static_cast<type> (std::log10(value)) * type(20.0); });
+        } else {
+            return Reg::multiply(approximateLog2<Reg, Accuracy>(amplitude), Reg::expand(6.0205999132796239042));
+        }
+    }
+    
+private:
+    template <typename Reg>
+    static typename Reg::vector floor(typename Reg::vector x)
+    {
+        auto truncated = Reg::truncate(x);
+        return Reg::select(Reg::greaterThan(truncated, x), Reg::subtract(truncated, Reg::expand(1.0)), truncated);
+    }
+    
+    /** Evaluates c[0] + c[1] x + c[2] x^2 + ... using Horner's method.
+    */
+    template <typename Reg>
+    static typename Reg::vector evaluatePolynomial(const double* coefficients, int order, typename Reg::vector x)
+    {
+        auto result = Reg::expand(static_cast<type> (coefficients[order - 1]));
+        for (int index = order - 2; index >= 0; --index) {
+            result = Reg::add(Reg::expand(static_cast<type> (coefficients[index])), Reg::multiply(result, x));
+        }
+        return result;
+    }
+    
+    /** Finds the table cell of each lane, clamped to the cells of the table, and returns the
+        position within it, which is outside 0 to 1 for values beyond the ends of the table.
+    */
+    template <typename Reg>
+    static typename Reg::vector findTableCell(typename Reg::vector x, int numPoints, type start, type step, typename Reg::vector& cell)
+    {
+        auto position = Reg::multiply(Reg::subtract(x, Reg::expand(start)), Reg::expand(type (1.0) / step));
+        // The comparison sends NaN to the first cell, so it can never index outside the table.
+        auto clamped = Reg::select(Reg::greaterThan(position, Reg::expand(0.0)), position, Reg::expand(0.0));
+        cell = floor<Reg>(Reg::min(clamped, Reg::expand(type (numPoints - 2))));
+        return Reg::subtract(position, cell);
+    }
+    
+    /** Loads table[cell + offset] for each lane.
+    */
+    template <typename Reg>
+    static typename Reg::vector gather(const type* table, typename Reg::vector cell, int offset)
+    {
+        type lanes[Reg::size];
+        Reg::store(lanes, cell);
+        for (int lane = 0; lane < Reg::size; ++lane) {
+            lanes[lane] = table[static_cast<int> (lanes[lane]) + offset];
+        }
+        return Reg::load(lanes);
+    }
+    
+    template <typename Reg>
+    static typename Reg::vector interpolateTable(typename Reg::vector x, const type* table, int numPoints, type start, type step)
+    {
+        typename Reg::vector cell;
+        auto fraction = findTableCell<Reg>(x, numPoints, start, step, cell);
+        fraction = Reg::min(Reg::max(fraction, Reg::expand(0.0)), Reg::expand(1.0));
+        auto low = gather<Reg>(table, cell, 0);
+        return Reg::add(low, Reg::multiply(fraction, Reg::subtract(gather<Reg>(table, cell, 1), low)));
+    }
+    
+    template <typename Reg>
+    static typename Reg::vector integrateTable(typename Reg::vector x, const type* table, const type* integrals, int numPoints, type start, type step)
+    {
+        typename Reg::vector cell;
+        auto fraction = findTableCell<Reg>(x, numPoints, start, step, cell);
+        auto low = gather<Reg>(table, cell, 0);
+        auto high = gather<Reg>(table, cell, 1);
+        auto inside = Reg::min(Reg::max(fraction, Reg::expand(0.0)), Reg::expand(1.0));
+        auto area = Reg::multiply(inside, Reg::add(low, Reg::multiply(Reg::multiply(Reg::expand(0.5), inside), Reg::subtract(high, low))));
+        // Beyond the ends of the table the function is constant, so its integral grows linearly.
+        area = Reg::add(area, Reg::multiply(Reg::min(fraction, Reg::expand(0.0)), low));
+        area = Reg::add(area, Reg::multiply(Reg::max(Reg::subtract(fraction, Reg::expand(1.0)), Reg::expand(0.0)), high));
+        return Reg::add(gather<Reg>(integrals, cell, 0), Reg::multiply(Reg::expand(step), area));
+    }
+    
+    template <typename Reg, typename Function>
+    static typename Reg::vector applyToLanes(typename Reg::vector x, Function function)
+    {
+        type lanes[Reg::size];
+        Reg::store(lanes, x);
+        for (int lane = 0; lane < Reg::size; ++lane) {
+            lanes[lane] = function(lanes[lane]);
+        }
+        return Reg::load(lanes);
+    }
+    
+    /** The waveshapes of Maths at a phase from 0 to 1, chosen per lane. The sine is the fast approximation.
+    */
+    template <typename Reg, typename Accuracy, bool isSineOnly>
+    static typename Reg::vector generateWaveshape(typename Reg::vector phase, typename Reg::vector waveshape)
+    {
+        auto sine = approximateSine<Reg, Accuracy>(phase);
+        if (isSineOnly) {
+            return sine;
+        }
+        auto four = Reg::multiply(Reg::expand(4.0), phase);
+        auto triangle = Reg::select(Reg::greaterThan(Reg::expand(0.25), phase), four,
+                                    Reg::select(Reg::greaterThan(Reg::expand(0.75), phase), Reg::subtract(Reg::expand(2.0), four), Reg::subtract(four, Reg::expand(4.0))));
+        auto square = Reg::select(Reg::greaterThan(Reg::expand(0.5), phase), Reg::expand(1.0), Reg::expand(-1.0));
+        auto saw = Reg::subtract(Reg::expand(1.0), Reg::multiply(Reg::expand(2.0), phase));
+        return Reg::select(Reg::greaterThan(waveshape, Reg::expand(2.5)), saw,
+                           Reg::select(Reg::greaterThan(waveshape, Reg::expand(1.5)), square,
+                                       Reg::select(Reg::greaterThan(waveshape, Reg::expand(0.5)), triangle, sine)));
+    }
+    
+    template <typename Reg>
+    static typename Reg::vector advancePhase(typename Reg::vector phase, typename Reg::vector increment)
+    {
+        phase = Reg::add(phase, increment);
+        return Reg::subtract(phase, Reg::truncate(phase));
+    }
+    
+    template <typename Reg, typename Accuracy>
+    static void renderOscillatorGroup(type* phases, const type* increments, const type* waveshapes, const type* gains, type* const* outputs, int numSamples)
+    {
+        type frame[Reg::size];
+        auto phase = Reg::load(phases);
+        auto increment = Reg::load(increments);
+        auto waveshape = Reg::load(waveshapes);
+        auto gain = Reg::load(gains);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            Reg::store(frame, Reg::multiply(gain, generateWaveshape<Reg, Accuracy, false>(phase, waveshape)));
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                outputs[lane][sample] = frame[lane];
+            }
+            phase = advancePhase<Reg>(phase, increment);
+        }
+        Reg::store(phases, phase);
+    }
+    
+    template <typename Accuracy, bool isSineOnly>
+    static void sumOscillatorBlock(type* phases, const type* increments, const type* waveshapes, const type* gains, type* dest, int numVoices, int numSamples)
+    {
+        type lanes[Register::size];
+        for (int sample = 0; sample < numSamples; ++sample) {
+            auto sum = Register::expand(0.0);
+            int voice = 0;
+            for (; voice + Register::size <= numVoices; voice += Register::size) {
+                auto phase = Register::load(phases + voice);
+                auto value = generateWaveshape<Register, Accuracy, isSineOnly>(phase, Register::load(waveshapes + voice));
+                sum = Register::add(sum, Register::multiply(Register::load(gains + voice), value));
+                Register::store(phases + voice, advancePhase<Register>(phase, Register::load(increments + voice)));
+            }
+            Register::store(lanes, sum);
+            type total = 0.0;
+            for (int lane = 0; lane < Register::size; ++lane) {
+                total += lanes[lane];
+            }
+            for (; voice < numVoices; ++voice) {
+                total += gains[voice] * generateWaveshape<Scalar, Accuracy, isSineOnly>(phases[voice], waveshapes[voice]);
+                phases[voice] = advancePhase<Scalar>(phases[voice], increments[voice]);
+            }
+            dest[sample] = total;
+        }
+    }
+    
+    template <typename Reg, bool rms>
+    static void followEnvelopeGroup(const type* const* input, type* const* output, type* state, int numSamples, type attackCoefficient, type releaseCoefficient)
+    {
+        type frame[Reg::size];
+        auto attack = Reg::expand(attackCoefficient);
+        auto release = Reg::expand(releaseCoefficient);
+        auto lastOut = Reg::load(state);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                frame[lane] = input[lane][sample];
+            }
+            auto value = Reg::load(frame);
+            if (rms) {
+                // The state is the mean square, so value > sqrt(state) is tested without the square root.
+                auto square = Reg::multiply(value, value);
+                auto coefficient = Reg::select(Reg::greaterThan(value, Reg::expand(0.0)), Reg::select(Reg::greaterThan(square, lastOut), attack, release), release);
+                lastOut = Reg::add(square, Reg::multiply(coefficient, Reg::subtract(lastOut, square)));
+                Reg::store(frame, Reg::sqrt(lastOut));
+            } else {
+                auto coefficient = Reg::select(Reg::greaterThan(value, lastOut), attack, release);
+                lastOut = Reg::add(value, Reg::multiply(coefficient, Reg::subtract(lastOut, value)));
+                Reg::store(frame, lastOut);
+            }
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                output[lane][sample] = frame[lane];
+            }
+        }
+        Reg::store(state, lastOut);
+    }
+    
+    template <typename Reg, bool isRamping>
+    static void filterBiquadGroup(type* const* data, type* state1, type* state2, int numSamples, const type* coefficients, const type* increments)
+    {
+        type frame[Reg::size];
+        auto b0 = Reg::expand(coefficients[0]), b1 = Reg::expand(coefficients[1]), b2 = Reg::expand(coefficients[2]);
+        auto a1 = Reg::expand(coefficients[3]), a2 = Reg::expand(coefficients[4]);
+        auto s1 = Reg::load(state1), s2 = Reg::load(state2);
+        for (int sample = 0; sample < numSamples; ++sample) {
+            if (isRamping) {
+                b0 = Reg::add(b0, Reg::expand(increments[0]));
+                b1 = Reg::add(b1, Reg::expand(increments[1]));
+                b2 = Reg::add(b2, Reg::expand(increments[2]));
+                a1 = Reg::add(a1, Reg::expand(increments[3]));
+                a2 = Reg::add(a2, Reg::expand(increments[4]));
+            }
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                frame[lane] = data[lane][sample];
+            }
+            auto input = Reg::load(frame);
+            auto output = Reg::add(Reg::multiply(b0, input), s1);
+            s1 = Reg::add(Reg::subtract(Reg::multiply(b1, input), Reg::multiply(a1, output)), s2);
+            s2 = Reg::subtract(Reg::multiply(b2, input), Reg::multiply(a2, output));
+            Reg::store(frame, output);
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                data[lane][sample] = frame[lane];
+            }
+        }
+        Reg::store(state1, s1);
+        Reg::store(state2, s2);
+    }
+    
+    template <typename Reg, bool isRamping>
+    static void filterBiquadCascadeGroup(const type* const* input, type* const* output, type* state, int numChannels, int numSamples, const type* coefficients, const type* increments, int numStages)
+    {
+        type frame[Reg::size];
+        for (int sample = 0; sample < numSamples; ++sample) {
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                frame[lane] = input[lane][sample];
+            }
+            auto value = Reg::load(frame);
+            auto step = Reg::expand(type (sample + 1));
+            for (int stage = 0; stage < numStages; ++stage) {
+                auto coefficient = [&] (int index) {
+                    auto offset = (5 * stage + index) * numChannels;
+                    auto current = Reg::load(coefficients + offset);
+                    if (isRamping) {
+                        current = Reg::add(current, Reg::multiply(step, Reg::load(increments + offset)));
+                    }
+                    return current;
+                };
+                auto state1 = state + 2 * stage * numChannels;
+                auto state2 = state1 + numChannels;
+                auto result = Reg::add(Reg::multiply(coefficient(0), value), Reg::load(state1));
+                auto feedForward = Reg::multiply(coefficient(1), value);
+                Reg::store(state1, Reg::add(Reg::subtract(feedForward, Reg::multiply(coefficient(3), result)), Reg::load(state2)));
+                feedForward = Reg::multiply(coefficient(2), value);
+                Reg::store(state2, Reg::subtract(feedForward, Reg::multiply(coefficient(4), result)));
+                value = result;
+            }
+            Reg::store(frame, value);
+            for (int lane = 0; lane < Reg::size; ++lane) {
+                output[lane][sample] = frame[lane];
+            }
+        }
+    }
+    
+    template <typename Reg>
+    static typename Reg::vector tanHEstimate(typename Reg::vector input)
+    {
+        input = Reg::min(Reg::expand(3.0506), Reg::max(Reg::expand(-3.0506), input));
+        auto squared = Reg::multiply(input, input);
+        auto denominator = Reg::add(Reg::expand(5.0), Reg::divide(squared, Reg::expand(7.0)));
+        denominator = Reg::add(Reg::expand(3.0), Reg::divide(squared, denominator));
+        denominator = Reg::add(Reg::expand(1.0), Reg::divide(squared, denominator));
+        return Reg::divide(input, denominator);
+    }
+};
@@ -0,0 +1,188 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#ifndef DSPTOOLS_VECTOR_OPERATIONS_HEADER_INCLUDED
+#define DSPTOOLS_VECTOR_OPERATIONS_HEADER_INCLUDED
+
+#include <algorithm>
+#include <limits>
+#include "SIMDRegister.h"
+#include "CPUFeatures.h"
+#include "FastMathsPolicies.h"
+
+namespace DSPTools {
+
+namespace ScalarKernels {
+ #define DSPTOOLS_KERNEL_INSTRUCTIONS ScalarInstructions
+ #include "VectorKernels.h"
+ #undef DSPTOOLS_KERNEL_INSTRUCTIONS
+} // namespace ScalarKernels
+
+#if defined (DSPTOOLS_HAS_X86_SIMD)
+namespace SSE2Kernels {
+ #define DSPTOOLS_KERNEL_INSTRUCTIONS SSE2Instructions
+ #include "VectorKernels.h"
+ #undef DSPTOOLS_KERNEL_INSTRUCTIONS
+} // namespace SSE2Kernels
+
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__ ((target ("avx2"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target ("avx2")
+#endif
+namespace AVX2Kernels {
+ #define DSPTOOLS_KERNEL_INSTRUCTIONS AVX2Instructions
+ #include "VectorKernels.h"
+ #undef DSPTOOLS_KERNEL_INSTRUCTIONS
+} // namespace AVX2Kernels
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__ ((target ("avx512f"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target ("avx512f")
+#endif
+namespace AVX512Kernels {
+ #define DSPTOOLS_KERNEL_INSTRUCTIONS AVX512Instructions
+ #include "VectorKernels.h"
+ #undef DSPTOOLS_KERNEL_INSTRUCTIONS
+} // namespace AVX512Kernels
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+#endif
+
+#if defined (DSPTOOLS_HAS_GENERIC_VECTOR)
+namespace GenericVectorKernels {
+ #define DSPTOOLS_KERNEL_INSTRUCTIONS GenericVectorInstructions
+ #include "VectorKernels.h"
+ #undef DSPTOOLS_KERNEL_INSTRUCTIONS
+} // namespace GenericVectorKernels
+#endif
+
+/** A table of the block kernels in VectorKernels.h, bound to one instruction set.
+    Processors get the table from getBest() in setup() and call through it, so a single
+    build uses the widest instruction set of whichever CPU it runs on. The maths kernels
+    use the given accuracy policy from FastMathsPolicies.h.
+*/
+template <typename type, typename Accuracy = HighAccuracy>
+struct VectorOperations
+{
+    void (*multiply)(type* data, const type* values, int numSamples);
+    void (*multiplyByValue)(type* data, type value, int numSamples);
+    void (*addScaled)(type* dest, const type* source, type gain, int numSamples);
+    void (*convolve)(type* dest, const type* source, const type* coefficients, int numTaps, int numSamples);
+    void (*panPositionsToGains)(type* values, int numSamples, bool leftChannel);
+    void (*followEnvelopes)(const type* const* input, type* const* output, type* state, int numChannels, int numSamples, type attackCoefficient, type releaseCoefficient, bool rms);
+    void (*filterBiquads)(type* const* data, type* state, int numChannels, int numSamples, const type* coefficients, const type* increments);
+    void (*filterBiquadCascades)(const type* const* input, type* const* output, type* state, int numChannels, int numSamples, const type* coefficients, const type* increments, int numStages);
+    type (*generatePhases)(type* dest, int numSamples, type phase, type increment);
+    void (*linearRamp)(type* dest, int numSamples, type start, type increment, int firstStep);
+    type (*exponentialRamp)(type* dest, int numSamples, type value, type multiplier);
+    void (*tanHEstimate)(type* data, int numSamples);
+    void (*interpolateTable)(type* data, const type* table, int numPoints, type start, type step, int numSamples);
+    void (*integrateTable)(type* data, const type* table, const type* integrals, int numPoints, type start, type step, int numSamples);
+    void (*exp2)(type* data, int numSamples);
+    void (*log2)(type* data, int numSamples);
+    void (*sine)(type* data, int numSamples);
+    void (*decibelsToAmplitude)(type* data, int numSamples);
+    void (*amplitudeToDecibels)(type* data, int numSamples);
+    void (*renderOscillators)(type* phases, const type* increments, const type* waveshapes, const type* gains, type* const* outputs, int numVoices, int numSamples);
+    void (*sumOscillators)(type* phases, const type* increments, const type* waveshapes, const type* gains, type* dest, int numVoices, int numSamples);
+    
+    /** The number of values in one register of the instruction set. Kernels that put channels
+        across the lanes of a register run fastest when the channel count is a multiple of it.
+    */
+    int vectorSize;
+    
+    /** Get the kernels for the widest instruction set supported by the running CPU.
+        The CPU is only checked the first time this is called.
+    */
+    static const VectorOperations& getBest()
+    {
+        static const VectorOperations operations = chooseBest();
+        return operations;
+    }
+    
+    /** Get the kernels from one of the instruction set namespaces, e.g. create<ScalarKernels::Kernels>().
+    */
+    template <template <typename> class Kernels>
+    static VectorOperations create()
+    {
+        return {
+            &Kernels<type>::multiply,
+            &Kernels<type>::multiplyByValue,
+            &Kernels<type>::addScaled,
+            &Kernels<type>::convolve,
+            &Kernels<type>::panPositionsToGains,
+            &Kernels<type>::followEnvelopes,
+            &Kernels<type>::filterBiquads,
+            &Kernels<type>::filterBiquadCascades,
+            &Kernels<type>::generatePhases,
+            &Kernels<type>::linearRamp,
+            &Kernels<type>::exponentialRamp,
+            &Kernels<type>::tanHEstimate,
+            &Kernels<type>::interpolateTable,
+            &Kernels<type>::integrateTable,
+            &Kernels<type>::template exp2<Accuracy>,
+            &Kernels<type>::template log2<Accuracy>,
+            &Kernels<type>::template sine<Accuracy>,
+            &Kernels<type>::template decibelsToAmplitude<Accuracy>,
+            &Kernels<type>::template amplitudeToDecibels<Accuracy>,
+            &Kernels<type>::template renderOscillators<Accuracy>,
+            &Kernels<type>::template sumOscillators<Accuracy>,
+            Kernels<type>::Register::size
+        };
+    }
+    
+private:
+    static VectorOperations chooseBest()
+    {
+       #if defined (DSPTOOLS_HAS_X86_SIMD)
+        auto& cpu = CPUFeatures::get();
+        if (cpu.hasAVX512) {
+            return create<AVX512Kernels::Kernels>();
+        }
+        if (cpu.hasAVX2) {
+            return create<AVX2Kernels::Kernels>();
+        }
+        if (cpu.hasSSE2) {
+            return create<SSE2Kernels::Kernels>();
+        }
+       #elif defined (DSPTOOLS_HAS_GENERIC_VECTOR)
+        return create<GenericVectorKernels::Kernels>();
+       #endif
+        return create<ScalarKernels::Kernels>();
+    }
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_VECTOR_OPERATIONS_HEADER_INCLUDED
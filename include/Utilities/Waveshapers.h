@@ -24,6 +24,7 @@ SOFTWARE.*/
 #define DSPTOOLS_WAVESHAPERS_HEADER_INCLUDED
 
 #include "Maths.h"
+#include "VectorOperations.h"
 
 namespace DSPTools {
 
@@ -33,7 +34,7 @@ class Waveshapers
 public:
     static type arraya(type input)
     {
-        return (input > 1.0) ? 1.0 : (input < 1.0) ? -1.0 : ((3.0 * input) / 2.0) * (1.0 - (input * input) / 3.0);
+        return (input > 1.0) ? 1.0 : (input < -1.0) ? -1.0 : ((3.0 * input) / 2.0) * (1.0 - (input * input) / 3.0);
     }
     
     static type sigmoid(type input)
@@ -54,6 +55,13 @@ public:
         input = Maths<type>::limit(-3.0506, 3.0506, input);
         return input / (1.0 + (input * input) / (3.0 + (input * input) / (5.0 + (input * input) / 7.0)));
     }
+    
+    /** Estimation of a tanh() function applied to a buffer of samples.
+    */
+    static void tanHEstimate(type* data, int numSamples)
+    {
+        VectorOperations<type>::getBest().tanHEstimate(data, numSamples);
+    }
 };
 
 } // namespace DSPTools
@@ -0,0 +1,114 @@
+/*MIT License
+
+Copyright (c) 2022 David Antonia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#ifndef DSPTOOLS_WORK_STEALING_QUEUE_HEADER_INCLUDED
+#define DSPTOOLS_WORK_STEALING_QUEUE_HEADER_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <cassert>
+
+namespace DSPTools {
+
+/** A fixed capacity, lock-free work stealing deque of task indices (Chase and Lev, with the
+    memory ordering of Lê et al.). One owner thread pushes and pops at the bottom, and any
+    other thread may steal from the top. Nothing allocates after setup, so every operation is
+    safe to call from the audio thread.
+*/
+class WorkStealingQueue
+{
+public:
+    WorkStealingQueue() {}
+    ~WorkStealingQueue() {}
+    
+    /** Allocate space for at least the given number of tasks. This must not be called while
+        other threads are using the queue.
+    */
+    void setup(int capacity)
+    {
+        size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        tasks.reset(new std::atomic<int>[size]);
+        top.store(0);
+        bottom.store(0);
+    }
+    
+    /** Add a task to the bottom of the queue. Only the owner thread may call this.
+    */
+    void push(int task)
+    {
+        long b = bottom.load(std::memory_order_relaxed);
+        assert(b - top.load(std::memory_order_acquire) < size);
+        tasks[b & (size - 1)].store(task, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+    
+    /** Take the newest task from the bottom of the queue. Only the owner thread may call this.
+        Returns false if the queue was empty.
+    */
+    bool pop(int& task)
+    {
+        long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        task = tasks[b & (size - 1)].load(std::memory_order_relaxed);
+        if (t == b) {
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+    
+    /** Take the oldest task from the top of the queue. Any thread may call this.
+        Returns false if the queue was empty or another thread took the task first.
+    */
+    bool steal(int& task)
+    {
+        long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        task = tasks[t & (size - 1)].load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+    
+private:
+    std::unique_ptr<std::atomic<int>[]> tasks;
+    long size = 0;
+    std::atomic<long> top {0};
+    std::atomic<long> bottom {0};
+};
+
+} // namespace DSPTools
+
+#endif // DSPTOOLS_WORK_STEALING_QUEUE_HEADER_INCLUDED